@@ -0,0 +1,132 @@
+#ifndef __BENCH_BENCHMARK_HPP__
+#define __BENCH_BENCHMARK_HPP__
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "allocation.hpp"
+
+// registers a benchmark run once per template size
+#define BENCHMARK(GROUP, NAME) \
+    static void GROUP##_##NAME##_Benchmark(Benchmark::Context& context); \
+    static Benchmark::Registrar GROUP##_##NAME##_Registrar(#GROUP "." #NAME, true, GROUP##_##NAME##_Benchmark); \
+    static void GROUP##_##NAME##_Benchmark(Benchmark::Context& context)
+
+// registers a benchmark that does not depend on the template size, run once
+#define BENCHMARK_UNSIZED(GROUP, NAME) \
+    static void GROUP##_##NAME##_Benchmark(Benchmark::Context& context); \
+    static Benchmark::Registrar GROUP##_##NAME##_Registrar(#GROUP "." #NAME, false, GROUP##_##NAME##_Benchmark); \
+    static void GROUP##_##NAME##_Benchmark(Benchmark::Context& context)
+
+namespace Benchmark {
+    // one benchmark at one size, every value per call of the measured body
+    struct Result {
+        Result() : size(0), pixels(0.0), calls(0), nanoseconds(0.0), allocations(0.0), iterations(0.0), converged(-1.0) {
+        }
+
+        std::string name;
+        int size;
+        double pixels;
+        long calls;
+        double nanoseconds;
+        double allocations;
+        // tracker iterations, 0 for benchmarks that do not track
+        double iterations;
+        // fraction of tracked calls that converged, negative for benchmarks that do not track
+        double converged;
+    };
+
+    class Context {
+        public:
+            Context(const std::string& name, int size, double minTime) : minTime(minTime), iterations(0), tracked(0), converged(0) {
+                this->result.name = name;
+                this->result.size = size;
+            }
+
+            int getSize() const {
+                return this->result.size;
+            }
+            // times body, doubling the calls until they take minTime seconds. the first call is a warm up
+            // that allocates the buffers, the allocations of the timed calls are counted by test/allocation.
+            // pixels is the work of one call, 0 when per pixel figures make no sense
+            template<typename F>
+            void measure(double pixels, F body) {
+                body();
+                long calls = 1;
+                while( true ) {
+                    this->iterations = 0;
+                    this->tracked = 0;
+                    this->converged = 0;
+                    Allocation::start();
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    for(long c=0; c<calls; c++) {
+                        body();
+                    }
+                    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    int allocations = Allocation::stop();
+
+                    if( elapsed >= this->minTime || calls >= (1L << 30) ) {
+                        this->result.pixels = pixels;
+                        this->result.calls = calls;
+                        this->result.nanoseconds = elapsed * 1e9 / calls;
+                        this->result.allocations = (double)allocations / calls;
+                        this->result.iterations = (double)this->iterations / calls;
+                        this->result.converged = this->tracked > 0 ? (double)this->converged / this->tracked : -1.0;
+                        return;
+                    }
+                    // aim a little past minTime, at most ten times the calls at once
+                    long aimed = elapsed > 0.0 ? (long)(calls * this->minTime * 1.2 / elapsed) : calls * 10;
+                    calls = std::max(calls * 2, std::min(calls * 10, aimed));
+                }
+            }
+            // called by a tracking body after every track()
+            void count(int iterations, bool converged) {
+                this->iterations += iterations;
+                this->tracked++;
+                this->converged += converged ? 1 : 0;
+            }
+            const Result& getResult() const {
+                return this->result;
+            }
+
+        private:
+            double minTime;
+            long iterations;
+            long tracked;
+            long converged;
+            Result result;
+    };
+
+    // keeps the compiler from dropping a computation whose result is never used
+    template<typename V>
+    inline void Keep(const V& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    typedef void (*Function)(Context& context);
+    struct Entry {
+        std::string name;
+        bool sized;
+        Function function;
+    };
+
+    // every registered benchmark, in registration order
+    inline std::vector<Entry>& Registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+
+    struct Registrar {
+        Registrar(const char* name, bool sized, Function function) {
+            Entry entry;
+            entry.name = name;
+            entry.sized = sized;
+            entry.function = function;
+            Registry().push_back(entry);
+        }
+    };
+}
+
+#endif //__BENCH_BENCHMARK_HPP__
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <utils/string.hpp>
+
+#include "benchmark.hpp"
+
+void help(char* execute) {
+    std::cerr << "usage: " << execute << " [-h] [-f FILTER] [-s SIZES] [-t MIN_TIME] [-o OUTPUT] [-l LABEL] [-b BASELINE]" << std::endl;
+    std::cerr << "" << std::endl;
+    std::cerr << "\t-h, --help                           show this help message and exit" << std::endl;
+    std::cerr << "\t-f, --filter    FILTER               run only the benchmarks whose name contains FILTER" << std::endl;
+    std::cerr << "\t-s, --sizes     SIZES                comma separated template SIZES (default:64,128,256,512)" << std::endl;
+    std::cerr << "\t-t, --time      MIN_TIME             time every benchmark for at least MIN_TIME seconds (default:0.2)" << std::endl;
+    std::cerr << "\t-o, --output    OUTPUT               write the results to the OUTPUT csv" << std::endl;
+    std::cerr << "\t-l, --label     LABEL                set the label column of the csv, like a commit (default:none)" << std::endl;
+    std::cerr << "\t-b, --baseline  BASELINE             compare the time per call with the BASELINE csv of an earlier run" << std::endl;
+    exit(-1);
+}
+
+static std::string key(const std::string& name, int size) {
+    return instant::Utils::String::Format("%s:%d", name.c_str(), size);
+}
+
+// a formatted figure, empty when it does not apply to the benchmark
+static std::string figure(bool applies, const char* format, double value) {
+    return applies ? instant::Utils::String::Format(format, value) : "";
+}
+
+static std::string dash(const std::string& text) {
+    return text.empty() ? "-" : text;
+}
+
+// time per call of every benchmark and size in a csv written by -o
+static std::map<std::string, double> readBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream input(path.c_str());
+    if( !input ) {
+        std::cerr << "cannot read " << path << std::endl;
+        exit(-1);
+    }
+    std::string line;
+    std::getline(input, line);
+    while( std::getline(input, line) ) {
+        std::vector<std::string> columns;
+        std::stringstream stream(line);
+        std::string column;
+        while( std::getline(stream, column, ',') ) {
+            columns.push_back(column);
+        }
+        if( columns.size() < 6 ) {
+            continue;
+        }
+        baseline[key(columns[1], atoi(columns[2].c_str()))] = atof(columns[5].c_str());
+    }
+    return baseline;
+}
+
+int main(int argc, char* argv[]) {
+    static struct option longOptions[] = {
+        {"help",      no_argument,       0, 'h'},
+        {"filter",    required_argument, 0, 'f'},
+        {"sizes",     required_argument, 0, 's'},
+        {"time",      required_argument, 0, 't'},
+        {"output",    required_argument, 0, 'o'},
+        {"label",     required_argument, 0, 'l'},
+        {"baseline",  required_argument, 0, 'b'},
+        {0, 0, 0, 0}
+    };
+
+    std::string filter;
+    std::vector<int> sizes;
+    double minTime = 0.2;
+    std::string outputPath;
+    std::string label;
+    std::string baselinePath;
+
+    int argopt, optionIndex=0;
+    while( (argopt = getopt_long(argc, argv, "hf:s:t:o:l:b:", longOptions, &optionIndex)) != -1 ) {
+        switch( argopt ) {
+            case 'f':
+                filter = std::string(optarg);
+                break;
+            case 's': {
+                std::stringstream stream(optarg);
+                std::string size;
+                while( std::getline(stream, size, ',') ) {
+                    sizes.push_back(atoi(size.c_str()));
+                    if( sizes.back() < 16 ) {
+                        help(argv[0]);
+                    }
+                }
+                break;
+            }
+            case 't':
+                instant::Utils::String::ToPrimitive<double>(optarg, minTime);
+                break;
+            case 'o':
+                outputPath = std::string(optarg);
+                break;
+            case 'l':
+                label = std::string(optarg);
+                break;
+            case 'b':
+                baselinePath = std::string(optarg);
+                break;
+            case 'h':
+            default:
+                help(argv[0]);
+                break;
+        }
+    }
+    if( sizes.empty() ) {
+        int defaults[] = {64, 128, 256, 512};
+        sizes.assign(defaults, defaults + 4);
+    }
+    std::map<std::string, double> baseline;
+    if( !baselinePath.empty() ) {
+        baseline = readBaseline(baselinePath);
+    }
+
+    std::ofstream output;
+    if( !outputPath.empty() ) {
+        output.open(outputPath.c_str());
+        if( !output ) {
+            std::cerr << "cannot write " << outputPath << std::endl;
+            return -1;
+        }
+        output << "label,benchmark,size,pixels,calls,ns_per_call,ns_per_pixel,calls_per_sec,allocations_per_call,"
+               << "iterations_per_call,iterations_per_sec,converged" << std::endl;
+    }
+
+    std::cout << instant::Utils::String::Format("%-44s %5s %14s %10s %14s %10s %8s %9s",
+            "benchmark", "size", "ns/call", "ns/pixel", "calls/sec", "allocs", "iters", "baseline") << std::endl;
+    for(const Benchmark::Entry& entry : Benchmark::Registry()) {
+        if( entry.name.find(filter) == std::string::npos ) {
+            continue;
+        }
+        std::vector<int> runs = entry.sized ? sizes : std::vector<int>(1, 0);
+        for(int size : runs) {
+            Benchmark::Context context(entry.name, size, minTime);
+            entry.function(context);
+            const Benchmark::Result& result = context.getResult();
+
+            // figures that do not apply are left empty in the csv and shown as - in the table
+            bool perPixel = result.pixels > 0.0;
+            bool tracking = result.converged >= 0.0;
+            double nanosecondsPerPixel = perPixel ? result.nanoseconds / result.pixels : 0.0;
+            double callsPerSecond = result.nanoseconds > 0.0 ? 1e9 / result.nanoseconds : 0.0;
+            std::map<std::string, double>::const_iterator found = baseline.find(key(result.name, size));
+            bool compared = found != baseline.end() && found->second > 0.0;
+            std::cout << instant::Utils::String::Format("%-44s %5s %14.1f %10s %14.1f %10.2f %8s %9s",
+                    result.name.c_str(), dash(figure(size > 0, "%.0f", size)).c_str(), result.nanoseconds,
+                    dash(figure(perPixel, "%.3f", nanosecondsPerPixel)).c_str(), callsPerSecond, result.allocations,
+                    dash(figure(tracking, "%.2f", result.iterations)).c_str(),
+                    dash(figure(compared, "%+.1f%%", compared ? (result.nanoseconds / found->second - 1.0) * 100.0 : 0.0)).c_str()) << std::endl;
+
+            if( output.is_open() ) {
+                output << label << "," << result.name << "," << figure(size > 0, "%.0f", size) << ","
+                       << instant::Utils::String::Format("%.0f,%ld,%.3f,", result.pixels, result.calls, result.nanoseconds)
+                       << figure(perPixel, "%.6f", nanosecondsPerPixel) << ","
+                       << instant::Utils::String::Format("%.3f,%.3f,", callsPerSecond, result.allocations)
+                       << figure(tracking, "%.3f", result.iterations) << ","
+                       << figure(tracking, "%.3f", result.iterations * callsPerSecond) << ","
+                       << figure(tracking, "%.3f", result.converged) << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
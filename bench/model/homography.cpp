@@ -0,0 +1,60 @@
+#include <vector>
+
+#include <model/homography.hpp>
+
+#include "benchmark.hpp"
+
+static const cv::Matx33d Pose(1.02, 0.01, 12.0, -0.01, 0.98, -8.0, 0.0001, -0.0002, 1.0);
+
+// the jacobian at a point through the cv::Mat interface, jacobianAt plus the allocation of the result
+BENCHMARK_UNSIZED(Homography, jacobian) {
+    Stick::Homography homography;
+    homography.setMatx(Pose);
+    int x = 0;
+    context.measure(0, [&]() {
+        cv::Mat jacobian = homography.jacobian(cv::Point(x, x/2));
+        x = (x + 1) & 255;
+        Benchmark::Keep(jacobian.data);
+    });
+}
+
+// the fixed size jacobian the per pixel loops use
+BENCHMARK_UNSIZED(Homography, jacobianAt) {
+    Stick::Homography::Jacobian jacobian;
+    double x = 0.0;
+    context.measure(0, [&]() {
+        Stick::Homography::jacobianAt(Pose, x, x*0.5, jacobian);
+        x = x < 256.0 ? x + 1.0 : 0.0;
+        Benchmark::Keep(jacobian);
+    });
+}
+
+// the jacobians of one 512 pixel template row, as calculateSteepest takes them
+BENCHMARK_UNSIZED(Homography, jacobianRow) {
+    Stick::Homography homography;
+    int width = 512;
+    std::vector<double> row(2*homography.getParameterSize()*width);
+    context.measure(width, [&]() {
+        homography.jacobianRow(-width/2.0, 10.0, width, &row[0]);
+        Benchmark::Keep(row[0]);
+    });
+}
+
+BENCHMARK_UNSIZED(Homography, compose) {
+    Stick::Homography homography;
+    cv::Matx33d delta(1.001, 0.0002, 0.1, -0.0002, 0.999, -0.05, 0.00001, 0.0, 1.0);
+    context.measure(0, [&]() {
+        homography.setMatx(Pose);
+        homography.compose(delta);
+        Benchmark::Keep(homography);
+    });
+}
+
+BENCHMARK_UNSIZED(Homography, inverse) {
+    Stick::Homography homography;
+    homography.setMatx(Pose);
+    context.measure(0, [&]() {
+        cv::Mat inverse = homography.inverse();
+        Benchmark::Keep(inverse.data);
+    });
+}
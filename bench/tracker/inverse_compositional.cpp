@@ -0,0 +1,144 @@
+#include <random>
+#include <vector>
+
+#include <tracker/inverse_compositional.hpp>
+#include <model/homography.hpp>
+
+#include "benchmark.hpp"
+
+namespace Stick {
+    // the initialization steps one at a time on a template data object of the benchmark
+    class InverseCompositionalBenchmark : public InverseCompositional {
+        public:
+            explicit InverseCompositionalBenchmark(const cv::Mat& templateImage) : InverseCompositional(new Homography()) {
+                this->setTemplateImage(templateImage);
+                InverseCompositional::buildTemplatePyramid(this->steps, this->templateImage);
+            }
+
+            void calculateGradients() {
+                InverseCompositional::calculateGradients(this->steps.levels[0]);
+            }
+            void calculateSteepest() {
+                InverseCompositional::calculateSteepest(this->steps.levels[0]);
+            }
+            void calculateHessianInv() {
+                InverseCompositional::calculateHessianInv(this->steps.levels[0]);
+            }
+
+        protected:
+            TemplateData steps;
+    };
+}
+
+// blurred noise stretched to the full 8 bit range, the same for a size on every run
+static cv::Mat texture(int size) {
+    std::mt19937 random(size);
+    std::uniform_int_distribution<int> value(0, 255);
+    cv::Mat noise(size, size, CV_8UC1);
+    for(int y=0; y<size; y++) {
+        for(int x=0; x<size; x++) {
+            noise.at<unsigned char>(y, x) = value(random);
+        }
+    }
+    cv::Mat blurred;
+    cv::GaussianBlur(noise, blurred, cv::Size(9, 9), 2.0, 2.0);
+
+    int low = 255, high = 0;
+    for(int y=0; y<size; y++) {
+        for(int x=0; x<size; x++) {
+            low = std::min(low, (int)blurred.at<unsigned char>(y, x));
+            high = std::max(high, (int)blurred.at<unsigned char>(y, x));
+        }
+    }
+    cv::Mat stretched(size, size, CV_8UC1);
+    for(int y=0; y<size; y++) {
+        for(int x=0; x<size; x++) {
+            stretched.at<unsigned char>(y, x) = (blurred.at<unsigned char>(y, x) - low) * 255 / std::max(1, high - low);
+        }
+    }
+    return stretched;
+}
+
+// a template of size in the center of a frame with a quarter of the size around it, tracked on frames
+// moved by seeded homographies: up to 3% scale and shear, 3% of the size shift and a 1% perspective
+// corner displacement, all about the frame center
+class Scene {
+    public:
+        Scene(int size, int perturbations) : size(size) {
+            int border = size/4;
+            this->frame = texture(size + 2*border);
+            cv::Point2d center(this->frame.cols/2.0, this->frame.rows/2.0);
+
+            std::mt19937 random(size);
+            std::uniform_real_distribution<double> unit(-1.0, 1.0);
+            for(int p=0; p<perturbations; p++) {
+                cv::Matx33d motion(1.0 + 0.03*unit(random), 0.03*unit(random), 0.03*size*unit(random),
+                                   0.03*unit(random), 1.0 + 0.03*unit(random), 0.03*size*unit(random),
+                                   0.01/size*unit(random), 0.01/size*unit(random), 1.0);
+                cv::Matx33d toCenter(1.0, 0.0, -center.x, 0.0, 1.0, -center.y, 0.0, 0.0, 1.0);
+                cv::Matx33d fromCenter(1.0, 0.0, center.x, 0.0, 1.0, center.y, 0.0, 0.0, 1.0);
+                cv::Mat moved;
+                cv::warpPerspective(this->frame, moved, cv::Mat(fromCenter * motion * toCenter), this->frame.size());
+                this->moved.push_back(moved);
+            }
+        }
+
+        void initialize(Stick::InverseCompositional& tracker) const {
+            tracker.calculateTransformedImage(this->frame, cv::Size(this->size, this->size));
+            tracker.setTemplateImage( tracker.getTransformedImage() );
+            tracker.initialize();
+        }
+
+        int size;
+        cv::Mat frame;
+        std::vector<cv::Mat> moved;
+};
+
+BENCHMARK(InverseCompositional, calculateGradients) {
+    Stick::InverseCompositionalBenchmark tracker(texture(context.getSize()));
+    context.measure(context.getSize() * context.getSize(), [&]() {
+        tracker.calculateGradients();
+    });
+}
+
+BENCHMARK(InverseCompositional, calculateSteepest) {
+    Stick::InverseCompositionalBenchmark tracker(texture(context.getSize()));
+    tracker.calculateGradients();
+    context.measure(context.getSize() * context.getSize(), [&]() {
+        tracker.calculateSteepest();
+    });
+}
+
+BENCHMARK(InverseCompositional, calculateHessianInv) {
+    Stick::InverseCompositionalBenchmark tracker(texture(context.getSize()));
+    tracker.calculateGradients();
+    tracker.calculateSteepest();
+    context.measure(context.getSize() * context.getSize(), [&]() {
+        tracker.calculateHessianInv();
+    });
+}
+
+// one warp, error and update on the full resolution, from the identity every call
+BENCHMARK(InverseCompositional, trackIteration) {
+    Scene scene(context.getSize(), 1);
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.0, 1, 1);
+    scene.initialize(tracker);
+    context.measure(context.getSize() * context.getSize(), [&]() {
+        tracker.getModel()->initialize();
+        tracker.track(scene.moved[0]);
+        context.count(tracker.getIterations(), tracker.getStatus() == Stick::InverseCompositional::Converged);
+    });
+}
+
+// tracking to convergence over two pyramid levels, cycling through the perturbations
+BENCHMARK(InverseCompositional, trackConvergence) {
+    Scene scene(context.getSize(), 16);
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    scene.initialize(tracker);
+    size_t next = 0;
+    context.measure(context.getSize() * context.getSize(), [&]() {
+        tracker.getModel()->initialize();
+        tracker.track(scene.moved[next++ % scene.moved.size()]);
+        context.count(tracker.getIterations(), tracker.getStatus() == Stick::InverseCompositional::Converged);
+    });
+}
@@ -0,0 +1,81 @@
+#ifndef __IO_BINARY_FILE_HPP__
+#define __IO_BINARY_FILE_HPP__
+
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+namespace Stick {
+    // reads the values of a mapped binary file in order. owner and description name the format in the
+    // InvalidParameters thrown for a read past the end, like "TemplateCache" and "template cache"
+    class BinaryReader {
+        public:
+            BinaryReader(const char* data, size_t size, size_t offset, const std::string& owner, const std::string& description);
+
+            // the next size bytes, nothing is copied
+            const char* take(size_t size);
+            template<typename V>
+            V get() {
+                V value;
+                memcpy(&value, this->take(sizeof(V)), sizeof(V));
+                return value;
+            }
+            // skips the padding written by BinaryWriter::align()
+            void align();
+
+            size_t getRemaining() const {
+                return this->offset < this->size ? this->size - this->offset : 0;
+            }
+
+        private:
+            const char* data;
+            size_t size;
+            size_t offset;
+            std::string owner;
+            std::string description;
+    };
+
+    // writes a binary file to a temporary file renamed over path by commit(), so a reader never maps a half
+    // written file and readers mapping the previous one keep it intact. the temporary file is removed when
+    // never committed. throws InvalidParameters when the file cannot be written
+    class BinaryWriter {
+        public:
+            BinaryWriter(const std::string& path, const std::string& owner, const std::string& description);
+            virtual ~BinaryWriter();
+
+            void append(const void* data, size_t size);
+            template<typename V>
+            void put(const V& value) {
+                this->append(&value, sizeof(V));
+            }
+            // pads with zeros up to the next multiple of Alignment
+            void align();
+            // overwrites bytes appended before, like counts only known at the end
+            void patch(size_t offset, const void* data, size_t size);
+            void commit();
+
+            size_t getOffset() const {
+                return this->offset;
+            }
+
+            // aligned sections start on cache line boundaries of the mapping, like the buffers cv::Mat allocates
+            static const size_t Alignment = 64;
+
+        private:
+            void checkOpen();
+            void check(bool written);
+
+            std::string path;
+            std::string temporary;
+            std::string owner;
+            std::string description;
+            FILE* file;
+            size_t offset;
+
+            BinaryWriter(const BinaryWriter&);
+            BinaryWriter& operator=(const BinaryWriter&);
+    };
+}
+
+#endif //__IO_BINARY_FILE_HPP__
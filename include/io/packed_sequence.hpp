@@ -0,0 +1,84 @@
+#ifndef __IO_PACKED_SEQUENCE_HPP__
+#define __IO_PACKED_SEQUENCE_HPP__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <opencv2/opencv.hpp>
+
+#include "io/binary_file.hpp"
+
+namespace Stick {
+    // where a frame lies in a packed sequence
+    struct PackedFrame {
+        uint64_t offset;
+        int rows;
+        int cols;
+        std::string name;
+    };
+
+    // a recorded sequence of 8 bit gray frames packed into one file, replayed without decoding.
+    // the file holds a header (magic, version, byte order, frame count, index offset, frame rate), the frames
+    // each starting on a cache line boundary with rows stored back to back, and an index with the offset,
+    // size and original file name of every frame
+    class PackedSequence {
+        public:
+            static const uint32_t Version = 1;
+
+            // maps the file read only, throws InvalidParameters when it cannot be opened, is not a packed sequence,
+            // is of another version or byte order, or is truncated
+            explicit PackedSequence(const std::string& path);
+            virtual ~PackedSequence();
+
+            // true when path starts like a packed sequence, without mapping it
+            static bool IsPackedSequence(const std::string& path);
+
+            size_t getFrameCount() const {
+                return this->frames.size();
+            }
+            // frames per second the sequence was recorded at, 0 when unknown
+            double getRate() const {
+                return this->rate;
+            }
+            // a header on the mapped pixels, nothing is copied or decoded. the pixels are read only
+            // and valid as long as the sequence lives, preprocessing has to write into another buffer
+            cv::Mat getFrame(size_t index) const;
+            const std::string& getFrameName(size_t index) const;
+
+        protected:
+            void* address;
+            size_t length;
+            double rate;
+            std::vector<PackedFrame> frames;
+
+        private:
+            PackedSequence(const PackedSequence&);
+            PackedSequence& operator=(const PackedSequence&);
+    };
+
+    // writes a packed sequence one frame at a time through a BinaryWriter, the file appears at path with close()
+    class PackedSequenceWriter {
+        public:
+            // throws InvalidParameters when the temporary file cannot be created
+            explicit PackedSequenceWriter(const std::string& path, double rate=0.0);
+            virtual ~PackedSequenceWriter();
+
+            // throws InvalidParameters for an image that is not 8 bit gray or when writing fails
+            void append(const cv::Mat& image, const std::string& name="");
+            void close();
+
+            size_t getFrameCount() const {
+                return this->frames.size();
+            }
+
+        protected:
+            BinaryWriter writer;
+            std::vector<PackedFrame> frames;
+
+        private:
+            PackedSequenceWriter(const PackedSequenceWriter&);
+            PackedSequenceWriter& operator=(const PackedSequenceWriter&);
+    };
+}
+
+#endif //__IO_PACKED_SEQUENCE_HPP__
@@ -0,0 +1,44 @@
+#ifndef __MODEL_AFFINE_HPP__
+#define __MODEL_AFFINE_HPP__
+
+#include "model/static_model.hpp"
+
+namespace Stick {
+    // parameters: the first two pose rows, minus the identity
+    class Affine : public StaticModel<Affine, 6> {
+        public:
+            Affine() {
+            }
+            virtual ~Affine() {
+            }
+
+        public:
+            static inline cv::Matx33d normalize(const cv::Matx33d& pose) {
+                return cv::Matx33d(pose(0, 0), pose(0, 1), pose(0, 2),
+                                   pose(1, 0), pose(1, 1), pose(1, 2),
+                                   0.0, 0.0, 1.0);
+            }
+            static inline cv::Matx33d parametersToPose(const double* parameters) {
+                return cv::Matx33d(1.0 + parameters[0], parameters[1], parameters[2],
+                                   parameters[3], 1.0 + parameters[4], parameters[5],
+                                   0.0, 0.0, 1.0);
+            }
+            static inline void jacobianAt(const cv::Matx33d& pose, double x, double y, Jacobian& out) {
+                out(0, 0) = x;
+                out(0, 1) = y;
+                out(0, 2) = 1.0;
+                out(0, 3) = 0.0;
+                out(0, 4) = 0.0;
+                out(0, 5) = 0.0;
+
+                out(1, 0) = 0.0;
+                out(1, 1) = 0.0;
+                out(1, 2) = 0.0;
+                out(1, 3) = x;
+                out(1, 4) = y;
+                out(1, 5) = 1.0;
+            }
+    };
+}
+
+#endif //__MODEL_AFFINE_HPP__
@@ -0,0 +1,43 @@
+#ifndef __MODEL_EUCLIDEAN_HPP__
+#define __MODEL_EUCLIDEAN_HPP__
+
+#include <cmath>
+
+#include "model/static_model.hpp"
+
+namespace Stick {
+    // parameters: (tx, ty, theta)
+    class Euclidean : public StaticModel<Euclidean, 3> {
+        public:
+            Euclidean() {
+            }
+            virtual ~Euclidean() {
+            }
+
+        public:
+            // keeps the rotation orthonormal while poses are composed
+            static inline cv::Matx33d normalize(const cv::Matx33d& pose) {
+                double theta = std::atan2(pose(1, 0), pose(0, 0));
+                return cv::Matx33d(std::cos(theta), -std::sin(theta), pose(0, 2),
+                                   std::sin(theta),  std::cos(theta), pose(1, 2),
+                                   0.0, 0.0, 1.0);
+            }
+            static inline cv::Matx33d parametersToPose(const double* parameters) {
+                double theta = parameters[2];
+                return cv::Matx33d(std::cos(theta), -std::sin(theta), parameters[0],
+                                   std::sin(theta),  std::cos(theta), parameters[1],
+                                   0.0, 0.0, 1.0);
+            }
+            static inline void jacobianAt(const cv::Matx33d& pose, double x, double y, Jacobian& out) {
+                out(0, 0) = 1.0;
+                out(0, 1) = 0.0;
+                out(0, 2) = -y;
+
+                out(1, 0) = 0.0;
+                out(1, 1) = 1.0;
+                out(1, 2) = x;
+            }
+    };
+}
+
+#endif //__MODEL_EUCLIDEAN_HPP__
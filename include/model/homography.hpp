@@ -1,55 +1,67 @@
 #ifndef __MODEL_HOMOGRAPHY_HPP__
 #define __MODEL_HOMOGRAPHY_HPP__
 
-#include "model/model.hpp"
+#include "model/static_model.hpp"
 
 namespace Stick {
-    class Homography : public Model {
+    class Homography : public StaticModel<Homography, 8> {
         public:
             Homography() {
-                this->pose = cv::Mat::eye(cv::Size(3, 3), cv::DataType<double>::type);
             }
             virtual ~Homography() {
             }
 
         public:
-            virtual int getParameterSize() const {
-                return 8;
+            static inline cv::Matx33d normalize(const cv::Matx33d& pose) {
+                return pose * (1.0 / pose(2, 2));
             }
-
-            virtual void compose(const cv::Mat& delta) {
-                this->pose = this->pose * delta;
-                this->pose /= this->pose.at<double>(8);
+            static inline cv::Matx33d parametersToPose(const double* parameters) {
+                return cv::Matx33d(1.0 + parameters[0], parameters[1], parameters[2],
+                                   parameters[3], 1.0 + parameters[4], parameters[5],
+                                   parameters[6], parameters[7], 1.0);
             }
-            virtual cv::Mat inverse() const {
-                cv::Mat inv = this->pose.inv();
-                return inv / inv.at<double>(8);
+            static inline void jacobianAt(const cv::Matx33d& pose, double x, double y, Jacobian& out) {
+                double px = pose(0, 0)*x + pose(0, 1)*y + pose(0, 2);
+                double py = pose(1, 0)*x + pose(1, 1)*y + pose(1, 2);
+                double z = pose(2, 0)*x + pose(2, 1)*y + pose(2, 2);
+
+                out(0, 0) = x / z;
+                out(0, 1) = y / z;
+                out(0, 2) = 1.0 / z;
+                out(0, 3) = 0.0;
+                out(0, 4) = 0.0;
+                out(0, 5) = 0.0;
+                out(0, 6) = - x * px / (z * z);
+                out(0, 7) = - y * px / (z * z);
+
+                out(1, 0) = 0.0;
+                out(1, 1) = 0.0;
+                out(1, 2) = 0.0;
+                out(1, 3) = x / z;
+                out(1, 4) = y / z;
+                out(1, 5) = 1.0 / z;
+                out(1, 6) = - x * py / (z * z);
+                out(1, 7) = - y * py / (z * z);
             }
 
+            // the cv::Mat jacobians keep the 2x9 shape of the original interface, whose callers index
+            // the column of pose(2, 2). it is fixed by normalize(), so its derivative is always zero
             virtual cv::Mat jacobian(const cv::Point& at) const {
-                cv::Mat in = cv::Mat::ones(cv::Size(1, 3), cv::DataType<double>::type);
-                in.at<double>(0) = at.x;
-                in.at<double>(1) = at.y;
-                in.at<double>(2) = 1.0;
-                return this->jacobian(in);
+                return this->paddedJacobian(at.x, at.y);
             }
             virtual cv::Mat jacobian(const cv::Mat& in) const {
-                cv::Mat prime = this->pose * in;
-                double z = prime.at<double>(2);
-
-                cv::Mat out = cv::Mat::zeros(cv::Size(9, 2), cv::DataType<double>::type);
-                out.at<double>(0, 0) = in.at<double>(0) / z;
-                out.at<double>(0, 1) = in.at<double>(1) / z;
-                out.at<double>(0, 2) = in.at<double>(2) / z;
-                out.at<double>(0, 6) = - in.at<double>(0) * prime.at<double>(0) / (z * z);
-                out.at<double>(0, 7) = - in.at<double>(1) * prime.at<double>(0) / (z * z);
-
-                out.at<double>(1, 3) = in.at<double>(0) / z;
-                out.at<double>(1, 4) = in.at<double>(1) / z;
-                out.at<double>(1, 5) = in.at<double>(2) / z;
-                out.at<double>(1, 6) = - in.at<double>(0) * prime.at<double>(1) / (z * z);
-                out.at<double>(1, 7) = - in.at<double>(1) * prime.at<double>(1) / (z * z);
+                return this->paddedJacobian(in.at<double>(0), in.at<double>(1));
+            }
 
+        private:
+            cv::Mat paddedJacobian(double x, double y) const {
+                Jacobian jacobian;
+                jacobianAt(this->matx, x, y, jacobian);
+                cv::Mat out = cv::Mat::zeros(cv::Size(ParameterSize + 1, 2), cv::DataType<double>::type);
+                for(int p=0; p<ParameterSize; p++) {
+                    out.at<double>(0, p) = jacobian(0, p);
+                    out.at<double>(1, p) = jacobian(1, p);
+                }
                 return out;
             }
     };
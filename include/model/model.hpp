@@ -61,13 +61,56 @@ namespace Stick {
                 return out;
             }
 
+            // fixed size access to the 3x3 pose for the tracking loops, static models override these without touching the heap
+            virtual cv::Matx33d getMatx() const {
+                return this->pose;
+            }
+            virtual void setMatx(const cv::Matx33d& pose) {
+                cv::Mat(pose, false).copyTo(this->pose);
+            }
+
             virtual int getParameterSize() const = 0;
+            // a new model of the same type and pose, owned by the caller
+            virtual Model* clone() const = 0;
 
             virtual void compose(const cv::Mat& delta) = 0;
             virtual cv::Mat inverse() const = 0;
+            virtual void compose(const cv::Matx33d& delta) {
+                this->compose(cv::Mat(delta, false));
+            }
+            // inverse of the pose of a parameter update, normalized like inverse()
+            virtual cv::Matx33d inverseDelta(const double* parameters) const {
+                cv::Mat delta(this->getParameterSize(), 1, cv::DataType<double>::type, (void*)parameters);
+                cv::Matx33d pose = this->toPose(delta);
+                cv::Matx33d inv = pose.inv();
+                return inv * (1.0 / inv(2, 2));
+            }
+            // pose of a parameter update, by default the parameters are added to the identity in row order
+            virtual cv::Mat toPose(const cv::Mat& parameters) const {
+                cv::Mat pose = cv::Mat::eye(this->pose.size(), cv::DataType<double>::type);
+                for(int i=0; i<parameters.size().area(); i++) {
+                    pose.at<double>(i) += parameters.at<double>(i);
+                }
+                return pose;
+            }
 
             virtual cv::Mat jacobian(const cv::Point& at) const =0;
             virtual cv::Mat jacobian(const cv::Mat& in) const = 0;
+            // jacobians at (x+i, y) for i < width, row r of parameter p is written to out[(2*p+r)*width + i]
+            virtual void jacobianRow(double x, double y, int width, double* out) const {
+                int params = this->getParameterSize();
+                cv::Mat in = cv::Mat::ones(cv::Size(1, 3), cv::DataType<double>::type);
+                for(int i=0; i<width; i++) {
+                    in.at<double>(0) = x + i;
+                    in.at<double>(1) = y;
+
+                    cv::Mat jacobian = this->jacobian(in);
+                    for(int p=0; p<params; p++) {
+                        out[(2*p)*width + i] = jacobian.at<double>(cv::Point(p, 0));
+                        out[(2*p+1)*width + i] = jacobian.at<double>(cv::Point(p, 1));
+                    }
+                }
+            }
 
             virtual void draw(cv::Mat& image, const cv::Size& templateSize, const cv::Scalar& color, const int thickness=1) const {
                 cv::Point delta = cv::Point(image.size().width/2 - templateSize.width/2, image.size().height/2 - templateSize.height/2);
@@ -0,0 +1,43 @@
+#ifndef __MODEL_SIMILARITY_HPP__
+#define __MODEL_SIMILARITY_HPP__
+
+#include "model/static_model.hpp"
+
+namespace Stick {
+    // parameters: (a, b, tx, ty), pose [1+a -b tx; b 1+a ty]
+    class Similarity : public StaticModel<Similarity, 4> {
+        public:
+            Similarity() {
+            }
+            virtual ~Similarity() {
+            }
+
+        public:
+            // projects back onto scaled rotations while poses are composed
+            static inline cv::Matx33d normalize(const cv::Matx33d& pose) {
+                double a = (pose(0, 0) + pose(1, 1)) / 2.0;
+                double b = (pose(1, 0) - pose(0, 1)) / 2.0;
+                return cv::Matx33d(a, -b, pose(0, 2),
+                                   b,  a, pose(1, 2),
+                                   0.0, 0.0, 1.0);
+            }
+            static inline cv::Matx33d parametersToPose(const double* parameters) {
+                return cv::Matx33d(1.0 + parameters[0], -parameters[1], parameters[2],
+                                   parameters[1], 1.0 + parameters[0], parameters[3],
+                                   0.0, 0.0, 1.0);
+            }
+            static inline void jacobianAt(const cv::Matx33d& pose, double x, double y, Jacobian& out) {
+                out(0, 0) = x;
+                out(0, 1) = -y;
+                out(0, 2) = 1.0;
+                out(0, 3) = 0.0;
+
+                out(1, 0) = y;
+                out(1, 1) = x;
+                out(1, 2) = 0.0;
+                out(1, 3) = 1.0;
+            }
+    };
+}
+
+#endif //__MODEL_SIMILARITY_HPP__
@@ -0,0 +1,109 @@
+#ifndef __MODEL_STATIC_MODEL_HPP__
+#define __MODEL_STATIC_MODEL_HPP__
+
+#include "model/model.hpp"
+
+namespace Stick {
+    // fixed size base for models whose parameter count is known at compile time.
+    // Derived provides
+    //     static void jacobianAt(const cv::Matx33d& pose, double x, double y, Jacobian& out);
+    //     static cv::Matx33d normalize(const cv::Matx33d& pose);
+    //     static cv::Matx33d parametersToPose(const double* parameters);
+    // and the per pixel loops are instantiated on it, without virtual calls or heap allocations.
+    template<class Derived, int N>
+    class StaticModel : public Model {
+        public:
+            enum { ParameterSize = N };
+            typedef cv::Matx<double, 2, N> Jacobian;
+
+        protected:
+            StaticModel() {
+                this->matx = cv::Matx33d::eye();
+                this->pose = cv::Mat(3, 3, cv::DataType<double>::type, this->matx.val);
+            }
+            StaticModel(const StaticModel& other) : Model() {
+                this->matx = other.matx;
+                this->pose = cv::Mat(3, 3, cv::DataType<double>::type, this->matx.val);
+            }
+            StaticModel& operator=(const StaticModel& other) {
+                this->matx = other.matx;
+                return *this;
+            }
+
+        public:
+            virtual ~StaticModel() {
+            }
+
+            virtual int getParameterSize() const {
+                return N;
+            }
+            virtual Model* clone() const {
+                return new Derived(static_cast<const Derived&>(*this));
+            }
+
+            virtual cv::Matx33d getMatx() const {
+                return this->matx;
+            }
+            virtual void setMatx(const cv::Matx33d& pose) {
+                this->matx = pose;
+            }
+
+            virtual void initialize() {
+                this->matx = cv::Matx33d::eye();
+            }
+            virtual cv::Point transform(const cv::Point& point) const {
+                const cv::Matx33d& h = this->matx;
+                double z = h(2, 0)*point.x + h(2, 1)*point.y + h(2, 2);
+                double x = (h(0, 0)*point.x + h(0, 1)*point.y + h(0, 2)) / z;
+                double y = (h(1, 0)*point.x + h(1, 1)*point.y + h(1, 2)) / z;
+                return cv::Point(x+0.5, y+0.5);
+            }
+            using Model::transform;
+
+            virtual void compose(const cv::Mat& delta) {
+                cv::Matx33d matx = delta;
+                this->compose(matx);
+            }
+            virtual void compose(const cv::Matx33d& delta) {
+                this->matx = Derived::normalize(this->matx * delta);
+            }
+            virtual cv::Mat inverse() const {
+                return cv::Mat(this->inverseMatx());
+            }
+            cv::Matx33d inverseMatx() const {
+                return Derived::normalize(this->matx.inv());
+            }
+            virtual cv::Mat toPose(const cv::Mat& parameters) const {
+                return cv::Mat(Derived::parametersToPose(parameters.ptr<double>(0)));
+            }
+            virtual cv::Matx33d inverseDelta(const double* parameters) const {
+                return Derived::normalize(Derived::parametersToPose(parameters).inv());
+            }
+
+            virtual cv::Mat jacobian(const cv::Point& at) const {
+                Jacobian out;
+                Derived::jacobianAt(this->matx, at.x, at.y, out);
+                return cv::Mat(out);
+            }
+            virtual cv::Mat jacobian(const cv::Mat& in) const {
+                Jacobian out;
+                Derived::jacobianAt(this->matx, in.at<double>(0), in.at<double>(1), out);
+                return cv::Mat(out);
+            }
+            virtual void jacobianRow(double x, double y, int width, double* out) const {
+                Jacobian jacobian;
+                for(int i=0; i<width; i++) {
+                    Derived::jacobianAt(this->matx, x+i, y, jacobian);
+                    for(int p=0; p<N; p++) {
+                        out[(2*p)*width + i] = jacobian(0, p);
+                        out[(2*p+1)*width + i] = jacobian(1, p);
+                    }
+                }
+            }
+
+        protected:
+            cv::Matx33d matx;
+    };
+}
+
+#endif //__MODEL_STATIC_MODEL_HPP__
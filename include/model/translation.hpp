@@ -0,0 +1,36 @@
+#ifndef __MODEL_TRANSLATION_HPP__
+#define __MODEL_TRANSLATION_HPP__
+
+#include "model/static_model.hpp"
+
+namespace Stick {
+    // parameters: (tx, ty)
+    class Translation : public StaticModel<Translation, 2> {
+        public:
+            Translation() {
+            }
+            virtual ~Translation() {
+            }
+
+        public:
+            static inline cv::Matx33d normalize(const cv::Matx33d& pose) {
+                return cv::Matx33d(1.0, 0.0, pose(0, 2),
+                                   0.0, 1.0, pose(1, 2),
+                                   0.0, 0.0, 1.0);
+            }
+            static inline cv::Matx33d parametersToPose(const double* parameters) {
+                return cv::Matx33d(1.0, 0.0, parameters[0],
+                                   0.0, 1.0, parameters[1],
+                                   0.0, 0.0, 1.0);
+            }
+            static inline void jacobianAt(const cv::Matx33d& pose, double x, double y, Jacobian& out) {
+                out(0, 0) = 1.0;
+                out(0, 1) = 0.0;
+
+                out(1, 0) = 0.0;
+                out(1, 1) = 1.0;
+            }
+    };
+}
+
+#endif //__MODEL_TRANSLATION_HPP__
@@ -0,0 +1,68 @@
+#ifndef __PARALLEL_LATEST_SLOT_HPP__
+#define __PARALLEL_LATEST_SLOT_HPP__
+
+#include <mutex>
+#include <condition_variable>
+
+namespace Stick {
+    // single item buffer between a producer that must never wait and a consumer that only wants the newest item,
+    // like a camera and a tracker: an item not taken before the next put() is replaced and counted as dropped
+    template<typename T>
+    class LatestSlot {
+        public:
+            LatestSlot() {
+                this->full = false;
+                this->closed = false;
+                this->dropped = 0;
+            }
+            virtual ~LatestSlot() {
+            }
+
+            void put(const T& item) {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    if( this->full ) {
+                        this->dropped++;
+                    }
+                    this->item = item;
+                    this->full = true;
+                }
+                this->changed.notify_one();
+            }
+            // waits for an item newer than the last one taken, false once closed and empty
+            bool take(T& item) {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->changed.wait(lock, [this]() { return this->full || this->closed; });
+                if( !this->full ) {
+                    return false;
+                }
+                item = this->item;
+                this->item = T();
+                this->full = false;
+                return true;
+            }
+            // the item in the slot can still be taken, a waiting take() returns
+            void close() {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->closed = true;
+                }
+                this->changed.notify_all();
+            }
+            long getDropped() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->dropped;
+            }
+
+        protected:
+            T item;
+            bool full;
+            bool closed;
+            long dropped;
+
+            std::mutex mutex;
+            std::condition_variable changed;
+    };
+}
+
+#endif //__PARALLEL_LATEST_SLOT_HPP__
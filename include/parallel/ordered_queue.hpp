@@ -0,0 +1,77 @@
+#ifndef __PARALLEL_ORDERED_QUEUE_HPP__
+#define __PARALLEL_ORDERED_QUEUE_HPP__
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace Stick {
+    // bounded queue handing items from any number of producers to one consumer in index order.
+    // items are pushed with their index in any order and popped as 0, 1, 2, ...
+    // a producer blocks while its index is capacity or more ahead of the next item to pop,
+    // so at most capacity items are ever held
+    template<typename T>
+    class OrderedQueue {
+        public:
+            explicit OrderedQueue(int capacity) : slots(capacity > 0 ? capacity : 1), filled(slots.size(), false) {
+                this->next = 0;
+                this->closed = false;
+            }
+            virtual ~OrderedQueue() {
+            }
+
+            int getCapacity() const {
+                return (int)this->slots.size();
+            }
+
+            // false when the queue was closed before the item could be stored
+            bool push(long index, const T& item) {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                long capacity = (long)this->slots.size();
+                this->popped.wait(lock, [this, index, capacity]() { return this->closed || index < this->next + capacity; });
+                if( this->closed ) {
+                    return false;
+                }
+                this->slots[index % capacity] = item;
+                this->filled[index % capacity] = true;
+                this->pushed.notify_all();
+                return true;
+            }
+            // waits for the item of the next index, false once the queue is closed
+            bool pop(T& item) {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                long slot = this->next % (long)this->slots.size();
+                this->pushed.wait(lock, [this, slot]() { return this->closed || this->filled[slot]; });
+                if( this->closed ) {
+                    return false;
+                }
+                item = this->slots[slot];
+                this->slots[slot] = T();
+                this->filled[slot] = false;
+                this->next++;
+                this->popped.notify_all();
+                return true;
+            }
+            // wakes every waiting producer and consumer, later calls return false
+            void close() {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->closed = true;
+                }
+                this->pushed.notify_all();
+                this->popped.notify_all();
+            }
+
+        protected:
+            std::vector<T> slots;
+            std::vector<bool> filled;
+            long next;
+            bool closed;
+
+            std::mutex mutex;
+            std::condition_variable pushed;
+            std::condition_variable popped;
+    };
+}
+
+#endif //__PARALLEL_ORDERED_QUEUE_HPP__
@@ -0,0 +1,55 @@
+#ifndef __PARALLEL_THREAD_POOL_HPP__
+#define __PARALLEL_THREAD_POOL_HPP__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace Stick {
+    // fixed set of worker threads running batches of indexed tasks.
+    // run() splits the indices into one contiguous range per worker, a worker takes tasks from the front of its own range
+    // and, once it is empty, steals from the back of the others, so uneven tasks still keep every worker busy.
+    // a batch allocates nothing, workers sleep between batches
+    class ThreadPool {
+        public:
+            // 0 threads uses one per hardware thread
+            explicit ThreadPool(int threads=0);
+            virtual ~ThreadPool();
+
+            int getThreads() const {
+                return (int)this->workers.size();
+            }
+
+            // calls task(i) for every i < count on the workers and returns when all are done, one batch at a time.
+            // the first exception thrown by a task is rethrown here, the remaining tasks still run
+            void run(int count, const std::function<void(int)>& task);
+
+        protected:
+            struct Range {
+                int begin;
+                int end;
+                std::mutex mutex;
+            };
+
+            void work(int worker);
+            bool take(int worker, int& index);
+
+        protected:
+            std::vector<Range> ranges;
+            std::vector<std::thread> workers;
+
+            std::mutex mutex;
+            std::condition_variable started;
+            std::condition_variable finished;
+            const std::function<void(int)>* task;
+            unsigned long generation;
+            int remaining;
+            bool stopping;
+            std::exception_ptr exception;
+    };
+}
+
+#endif //__PARALLEL_THREAD_POOL_HPP__
@@ -0,0 +1,47 @@
+#ifndef __PREDICTOR_CONSTANT_ACCELERATION_HPP__
+#define __PREDICTOR_CONSTANT_ACCELERATION_HPP__
+
+#include "predictor/predictor.hpp"
+
+namespace Stick {
+    // p(t+1) = 3p(t) - 3p(t-1) + p(t-2), falls back to constant velocity while the history is short
+    class ConstantAcceleration : public Predictor {
+        public:
+            ConstantAcceleration() {
+                this->reset();
+            }
+            virtual ~ConstantAcceleration() {
+            }
+
+            virtual void reset() {
+                this->count = 0;
+            }
+            virtual void update(const cv::Matx33d& pose) {
+                for(int i=2; i>0; i--) {
+                    this->history[i] = this->history[i-1];
+                }
+                this->history[0] = pose;
+                this->count++;
+            }
+            virtual cv::Matx33d predict(const cv::Matx33d& pose) const {
+                if( this->count < 2 ) {
+                    return pose;
+                }
+                cv::Matx33d predicted = this->history[0];
+                for(int p=0; p<8; p++) {
+                    if( this->count < 3 ) {
+                        predicted.val[p] = 2.0*this->history[0].val[p] - this->history[1].val[p];
+                    } else {
+                        predicted.val[p] = 3.0*this->history[0].val[p] - 3.0*this->history[1].val[p] + this->history[2].val[p];
+                    }
+                }
+                return predicted;
+            }
+
+        protected:
+            cv::Matx33d history[3];
+            int count;
+    };
+}
+
+#endif //__PREDICTOR_CONSTANT_ACCELERATION_HPP__
@@ -0,0 +1,42 @@
+#ifndef __PREDICTOR_CONSTANT_VELOCITY_HPP__
+#define __PREDICTOR_CONSTANT_VELOCITY_HPP__
+
+#include "predictor/predictor.hpp"
+
+namespace Stick {
+    // p(t+1) = p(t) + (p(t) - p(t-1))
+    class ConstantVelocity : public Predictor {
+        public:
+            ConstantVelocity() {
+                this->reset();
+            }
+            virtual ~ConstantVelocity() {
+            }
+
+            virtual void reset() {
+                this->count = 0;
+            }
+            virtual void update(const cv::Matx33d& pose) {
+                this->previous = this->current;
+                this->current = pose;
+                this->count++;
+            }
+            virtual cv::Matx33d predict(const cv::Matx33d& pose) const {
+                if( this->count < 2 ) {
+                    return pose;
+                }
+                cv::Matx33d predicted = this->current;
+                for(int p=0; p<8; p++) {
+                    predicted.val[p] += this->current.val[p] - this->previous.val[p];
+                }
+                return predicted;
+            }
+
+        protected:
+            cv::Matx33d current;
+            cv::Matx33d previous;
+            int count;
+    };
+}
+
+#endif //__PREDICTOR_CONSTANT_VELOCITY_HPP__
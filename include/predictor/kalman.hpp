@@ -0,0 +1,76 @@
+#ifndef __PREDICTOR_KALMAN_HPP__
+#define __PREDICTOR_KALMAN_HPP__
+
+#include "predictor/predictor.hpp"
+
+namespace Stick {
+    // constant velocity kalman filter on every pose entry, state (value, velocity).
+    // all entries share the same covariance, so the gain only depends on processNoise/measurementNoise
+    class Kalman : public Predictor {
+        public:
+            Kalman(double processNoise=0.1, double measurementNoise=1.0) {
+                this->processNoise = processNoise;
+                this->measurementNoise = measurementNoise;
+                this->reset();
+            }
+            virtual ~Kalman() {
+            }
+
+            virtual void reset() {
+                this->count = 0;
+            }
+            virtual void update(const cv::Matx33d& pose) {
+                if( this->count == 0 ) {
+                    this->state = pose;
+                    this->velocity = cv::Matx33d::zeros();
+                    this->covariance = cv::Matx22d(this->measurementNoise, 0.0, 0.0, this->measurementNoise);
+                    this->count++;
+                    return;
+                }
+
+                // predict with F = [1 1; 0 1] and white noise acceleration
+                const cv::Matx22d& c = this->covariance;
+                double q = this->processNoise;
+                cv::Matx22d predicted(
+                        c(0, 0) + c(0, 1) + c(1, 0) + c(1, 1) + q/4.0, c(0, 1) + c(1, 1) + q/2.0,
+                        c(1, 0) + c(1, 1) + q/2.0,                     c(1, 1) + q);
+
+                // correct with H = [1 0]
+                double innovation = predicted(0, 0) + this->measurementNoise;
+                double k0 = predicted(0, 0) / innovation;
+                double k1 = predicted(1, 0) / innovation;
+                for(int p=0; p<8; p++) {
+                    double value = this->state.val[p] + this->velocity.val[p];
+                    double residual = pose.val[p] - value;
+                    this->state.val[p] = value + k0 * residual;
+                    this->velocity.val[p] += k1 * residual;
+                }
+                this->state.val[8] = pose.val[8];
+                this->covariance = cv::Matx22d(
+                        (1.0 - k0) * predicted(0, 0), (1.0 - k0) * predicted(0, 1),
+                        predicted(1, 0) - k1 * predicted(0, 0), predicted(1, 1) - k1 * predicted(0, 1));
+                this->count++;
+            }
+            virtual cv::Matx33d predict(const cv::Matx33d& pose) const {
+                if( this->count < 2 ) {
+                    return pose;
+                }
+                cv::Matx33d predicted = this->state;
+                for(int p=0; p<8; p++) {
+                    predicted.val[p] += this->velocity.val[p];
+                }
+                return predicted;
+            }
+
+        protected:
+            double processNoise;
+            double measurementNoise;
+
+            cv::Matx33d state;
+            cv::Matx33d velocity;
+            cv::Matx22d covariance;
+            int count;
+    };
+}
+
+#endif //__PREDICTOR_KALMAN_HPP__
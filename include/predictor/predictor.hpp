@@ -0,0 +1,31 @@
+#ifndef __PREDICTOR_PREDICTOR_HPP__
+#define __PREDICTOR_PREDICTOR_HPP__
+
+#include <opencv2/opencv.hpp>
+#include <utils/string.hpp>
+#include <utils/type.hpp>
+
+namespace Stick {
+    // initial pose of the next frame from the poses the tracker converged to.
+    // predictions work on the first eight pose entries, the homography parameters
+    class Predictor {
+        protected:
+            Predictor() {
+            }
+        public:
+            virtual ~Predictor() {
+            }
+            virtual std::string getName() const {
+                std::string className = instant::Utils::Type::GetTypeName(this);
+                return instant::Utils::String::Replace(className, "Stick::", "");
+            }
+
+            virtual void reset() = 0;
+            // converged pose of the last frame
+            virtual void update(const cv::Matx33d& pose) = 0;
+            // pose to start the next frame from, pose is returned as is until there is enough history
+            virtual cv::Matx33d predict(const cv::Matx33d& pose) const = 0;
+    };
+}
+
+#endif //__PREDICTOR_PREDICTOR_HPP__
@@ -0,0 +1,43 @@
+#ifndef __TRACKER_ESM_HPP__
+#define __TRACKER_ESM_HPP__
+
+#include <vector>
+
+#include "tracker/inverse_compositional.hpp"
+
+namespace Stick {
+    // efficient second-order minimization (Benhimane and Malis).
+    // the steepest descent images are the mean of the template and the warped image ones and are rebuilt every iteration,
+    // pyramid, pixel selection, predictor and reporting are shared with InverseCompositional
+    template<typename T>
+    class ESMT : public InverseCompositionalT<T> {
+        protected:
+            typedef TrackingLevel Level;
+
+        public:
+            ESMT(Model* model, double thresholdSumOfComposeDelta=0.5, int maxIteration=100, int pyramidLevel=1)
+                : InverseCompositionalT<T>(model, thresholdSumOfComposeDelta, maxIteration, pyramidLevel) {
+                // whole second-order steps overshoot far from the optimum
+                this->setMaxStep(2.0);
+            }
+            virtual ~ESMT() {
+                this->stopBuilder();
+            }
+
+            virtual void setTemplateData(const std::shared_ptr<const TemplateData>& templateData);
+
+        protected:
+            virtual void buildTemplateData(TemplateData& templateData, const cv::Mat& image);
+            virtual void calculateJacobians(Level& level);
+            virtual bool calculateDelta(int level, const cv::Matx33d& warp, double scale, double* delta);
+            virtual void allocateBuffers();
+
+        protected:
+            std::vector<double> hessian;
+    };
+
+    typedef ESMT<double> ESM;
+    typedef ESMT<float> ESMF;
+}
+
+#endif //__TRACKER_ESM_HPP__
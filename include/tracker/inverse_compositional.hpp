@@ -2,53 +2,310 @@
 #define __TRACKER_INVERSE_COMPOSITIONAL_HPP__
 
 #include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 #include <utils/string.hpp>
 
 #include "tracker/tracker.hpp"
+#include "tracker/kernels.hpp"
+#include "tracker/template_data.hpp"
+#include "tracker/template_cache.hpp"
 
 namespace Stick {
-    class InverseCompositional : public Tracker {
+    // T is the scalar type of the per pixel data: gradients, steepest descent images, samples and errors.
+    // float halves their memory and doubles the values per SIMD register, sums, Hessian and poses stay double.
+    // use the InverseCompositional (double) and InverseCompositionalF (float) typedefs below
+    template<typename T>
+    class InverseCompositionalT : public Tracker {
         public:
-            InverseCompositional(Model* model, double thresholdSumOfComposeDelta=0.5, int maxIteration=100) : Tracker(model) {
+            enum Status {
+                Converged,
+                MaxIteration,
+                TimedOut
+            };
+
+            // pyramidLevel is the number of resolutions tracked coarse-to-fine (1: full resolution only)
+            InverseCompositionalT(Model* model, double thresholdSumOfComposeDelta=0.5, int maxIteration=100, int pyramidLevel=1) : Tracker(model) {
                 this->thresholdSumOfComposeDelta = thresholdSumOfComposeDelta;
                 this->maxIteration = maxIteration;
+                this->pyramidLevel = pyramidLevel;
+                this->keepDebugImages = false;
+                this->threads = 1;
+                this->pixelFraction = 1.0;
+                this->sumOfComposeDelta = 0.0;
+                this->iter = -1;
+                this->squaredError = 0.0;
+                this->status = MaxIteration;
+                this->timeBudget = 0.0;
+                this->adaptiveIterations = false;
+                this->historyCount = 0;
+                this->measurePrediction = false;
+                this->savedIterations = 0;
+                this->maxStep = 0.0;
+                this->templateModel = model ? model->clone() : NULL;
+                if( this->templateModel ) {
+                    this->templateModel->initialize();
+                }
+                this->regionMargin = 0;
+                this->latestRequest = 0;
+                this->stoppingBuilder = false;
+            }
+            virtual ~InverseCompositionalT() {
+                this->stopBuilder();
+                if(this->templateModel) delete this->templateModel;
+                this->templateModel = NULL;
             }
-            virtual ~InverseCompositional() {
+            // named after the typedefs, InverseCompositionalT<float> is InverseCompositionalF
+            virtual std::string getName() const {
+                std::string name = Tracker::getName();
+                name = instant::Utils::String::Replace(name, "T<double>", "");
+                return instant::Utils::String::Replace(name, "T<float>", "F");
             }
 
             virtual void initialize();
+            // maps the template data saved at cachePath for this template and configuration, or builds and saves it.
+            // returns true when the data came from the cache
+            virtual bool initialize(const std::string& cachePath);
+            // builds the template data of image on a background thread while track() keeps following the current template.
+            // the first track() after the build switches to the new template before it reads the frame, so no frame waits for it.
+            // the future is ready once the data is built, or superseded by a later request, and rethrows what building threw.
+            // settings must not change while a build is pending, initialize() drops builds not switched to yet
+            std::shared_future<void> initializeAsync(const cv::Mat& image);
+            // switches to a template built by initializeAsync(), done by track() between frames. returns true when it did
+            bool updateTemplate();
             virtual void track(const cv::Mat& image, const double scale=1.0);
             virtual std::vector<cv::Mat> getPoseTrace() const {
-                return this->poseTrace;
+                std::vector<cv::Mat> poseTrace;
+                for(const cv::Matx33d& pose : this->poseTrace) {
+                    poseTrace.push_back(cv::Mat(pose));
+                }
+                return poseTrace;
             }
             virtual std::string getLogString() const {
-                return instant::Utils::String::Format("iter:%d, delta:%.2f",
-                        this->iter, this->sumOfComposeDelta);
+                std::string log = instant::Utils::String::Format("iter:%d, delta:%.2f, kernel:%s, status:%s",
+                        this->iter, this->sumOfComposeDelta, Kernels::get().name, this->getStatusName().c_str());
+                if( this->predictor ) {
+                    log += instant::Utils::String::Format(", predictor:%s, predicted:%.2fpx",
+                            this->predictor->getName().c_str(), this->getPredictionError());
+                    if( this->measurePrediction ) {
+                        log += instant::Utils::String::Format(", saved:%d", this->savedIterations);
+                    }
+                }
+                return log;
+            }
+            // iterations of the last track() summed over the pyramid levels
+            int getIterations() const {
+                return this->iter + 1;
+            }
+            // how the last track() ended, a timed out frame keeps the lowest error pose it reached
+            Status getStatus() const {
+                return this->status;
+            }
+            std::string getStatusName() const {
+                const char* status[] = {"converged", "max iteration", "timed out"};
+                return status[this->status];
+            }
+            // pose change of the last iteration of the last track(), compared with thresholdSumOfComposeDelta
+            double getSumOfComposeDelta() const {
+                return this->sumOfComposeDelta;
             }
 
+            // wall clock budget of one track() call in milliseconds, 0 for none
+            void setTimeBudget(double milliseconds) {
+                this->timeBudget = std::max(0.0, milliseconds);
+            }
+            double getTimeBudget() const {
+                return this->timeBudget;
+            }
+            // caps the iterations of a frame at twice the most the recent frames needed, a frame stopped
+            // by the cap counts as needing all of it
+            void setAdaptiveIterations(bool adaptiveIterations) {
+                this->adaptiveIterations = adaptiveIterations;
+            }
+            int getIterationCap() const;
+            // also tracks every frame from the pose of the frame before, as without the predictor, to count the
+            // iterations the prediction saved. doubles the cost of a frame, for evaluating predictors only
+            void setMeasurePrediction(bool measurePrediction) {
+                this->measurePrediction = measurePrediction;
+            }
+            // iterations the start without prediction needed more than the predicted one in the last track(),
+            // negative when the prediction cost iterations. 0 unless measured
+            int getSavedIterations() const {
+                return this->savedIterations;
+            }
+            // longest move of a template corner by one update, in pixels of the pyramid level, 0 for none. longer
+            // updates are shortened along their direction, the linearization only holds a few pixels far
+            void setMaxStep(double pixels) {
+                this->maxStep = std::max(0.0, pixels);
+            }
+            double getMaxStep() const {
+                return this->maxStep;
+            }
+
+            // transformed and error images are only produced when enabled, track() itself never needs them
+            void setKeepDebugImages(bool keepDebugImages) {
+                this->keepDebugImages = keepDebugImages;
+            }
             virtual cv::Mat getErrorImage() const {
                 return this->errorImage.clone();
             }
+            // template rows are split across threads when built with ENABLE_OPENMP, the results do not depend on it
+            void setThreads(int threads) {
+                this->threads = std::max(1, threads);
+            }
+            int getThreads() const {
+                return this->threads;
+            }
+            // tracks only the given fraction of template pixels with the largest Hessian contribution, applied by initialize()
+            void setPixelFraction(double pixelFraction) {
+                if( !(pixelFraction > 0.0 && pixelFraction <= 1.0) ) {
+                    throw MakeClassException(InvalidParameters, instant::Utils::String::Format("pixel fraction out of range (0, 1] (input:%f)", pixelFraction));
+                }
+                this->pixelFraction = pixelFraction;
+            }
+            double getPixelFraction() const {
+                return this->pixelFraction;
+            }
+            // limits every frame to the bounding box of the template at the predicted pose grown by margin pixels,
+            // the image pyramid is built and sampled only there. 0 reads the whole frame
+            void setRegionMargin(int margin) {
+                if( margin < 0 ) {
+                    throw MakeClassException(InvalidParameters, instant::Utils::String::Format("region margin must not be negative (input:%d)", margin));
+                }
+                this->regionMargin = margin;
+            }
+            int getRegionMargin() const {
+                return this->regionMargin;
+            }
+            // part of a frame of imageSize the next track() reads, preprocessing like blurring is only needed there
+            cv::Rect getRegion(const cv::Size& imageSize) const;
+            // blurs getRegion() of image, with the pixels around it as the border, into blurred, a frame sized buffer
+            // tracked in place of the frame. the pixels outside the region are left as they are, track() never reads them
+            void blurRegion(const cv::Mat& image, cv::Mat& blurred, const cv::Size& kernelSize, double sigma) const;
 
-        protected:
-            virtual void calculateGradients(double scale=1.0);
-            virtual void calculateSteepest();
-            virtual void calculateHessianInv();
+            int getPyramidLevel() const {
+                return this->templateData ? (int)this->templateData->levels.size() : this->pyramidLevel;
+            }
+
+            // the template data built by initialize(), shareable with any tracker of the same model and scalar type
+            std::shared_ptr<const TemplateData> getTemplateData() const {
+                return this->templateData;
+            }
+            // tracks a template built by another tracker without copying or recomputing it, in place of initialize()
+            virtual void setTemplateData(const std::shared_ptr<const TemplateData>& templateData);
+            // cache key of the template image with the tracker, model, scalar type, pyramid level and pixel fraction
+            uint64_t getTemplateKey() const;
 
         protected:
-            cv::Mat gradients;
-            cv::Mat steepest;
-            cv::Mat hessianInv;
+            typedef TrackingLevel Level;
 
+            // initialize() builds a new data object with these steps and hands it to setTemplateData()
+            virtual void buildTemplateData(TemplateData& templateData, const cv::Mat& image);
+            virtual void buildTemplatePyramid(TemplateData& templateData, const cv::Mat& image);
+            virtual void buildImagePyramid(const cv::Mat& image);
+            virtual void calculateGradients(Level& level, double scale=1.0);
+            virtual void calculateSteepest(Level& level);
+            virtual void selectPixels(Level& level);
+            virtual void calculateHessianInv(Level& level);
+            virtual cv::Matx33d calculateLevelPose(int level) const;
+            virtual void warpImage(int level, cv::Mat& transformedImage) const;
+            virtual void accumulateSteepestError(int level, const cv::Matx33d& warp, double scale, double* steepestError);
+            // parameter update of one iteration at the given level and warp, false when none can be solved for
+            virtual bool calculateDelta(int level, const cv::Matx33d& warp, double scale, double* delta);
+            int iterate(double scale, const std::chrono::steady_clock::time_point& start, double timeBudget, int iterationCap);
+            virtual void allocateBuffers();
+            // row scratch of the calling thread
+            T* getRowBuffer();
+            // runs body on the threads of the tracker, body splits its rows with an orphaned omp for.
+            // a single thread calls it directly, libgomp allocates a team for every parallel region even when disabled
+            template<typename F>
+            void parallelRows(const F& body) {
+#ifdef _OPENMP
+                if( this->threads > 1 ) {
+                    #pragma omp parallel num_threads(this->threads)
+                    body();
+                    return;
+                }
+#endif
+                body();
+            }
+
+            // worker of initializeAsync(), started by the first request. trackers overriding the build steps
+            // stop it in their destructor, a build running on must not call into a destroyed part of the object
+            void buildRequests();
+            void stopBuilder();
+            void dropTemplateRequests();
+
+        protected:
+            // shared and read only, everything below is the state of this tracker
+            std::shared_ptr<const TemplateData> templateData;
+            // the template jacobians are taken at the identity warp of this copy of the model,
+            // builds never read the pose track() is changing
+            Model* templateModel;
+            // pyramid of the region of the frame, poses stay in whole frame coordinates
+            std::vector<cv::Mat> imagePyramid;
+            // the coarser levels are views on buffers of the whole frame at their level, so a region changing
+            // size from frame to frame is downsampled without reallocating
+            std::vector<cv::Mat> pyramidBuffers;
+            // horizontal pass rows of the downsampling, sized for the widest level
+            std::vector<int> pyramidRows;
+            cv::Size imageSize;
+            cv::Rect region;
+            int regionMargin;
             cv::Mat errorImage;
+            bool keepDebugImages;
 
             double sumOfComposeDelta;
             int iter;
+            // mean squared error at the warp of the last calculateDelta()
+            double squaredError;
+            Status status;
+
+            double timeBudget;
+            bool adaptiveIterations;
+            static const int IterationHistorySize = 8;
+            int iterationHistory[IterationHistorySize];
+            int historyCount;
+            bool measurePrediction;
+            int savedIterations;
 
             double thresholdSumOfComposeDelta;
             int maxIteration;
-            std::vector<cv::Mat> poseTrace;
+            int pyramidLevel;
+            int threads;
+            double pixelFraction;
+            double maxStep;
+            std::vector<cv::Matx33d> poseTrace;
+
+            // working buffers of track(), sized by initialize() so tracking does not allocate after the first frame
+            std::vector<double> steepestError;
+            std::vector<double> delta;
+            std::vector<double> rowSums;
+            std::vector<std::vector<T> > rowBuffers;
+
+            struct TemplateRequest {
+                cv::Mat image;
+                unsigned long id;
+                std::shared_ptr<std::promise<void> > promise;
+            };
+            std::thread builder;
+            std::mutex builderMutex;
+            std::condition_variable requested;
+            std::deque<TemplateRequest> requests;
+            // only the latest request is ever switched to
+            unsigned long latestRequest;
+            bool stoppingBuilder;
+            std::shared_ptr<const TemplateData> builtTemplate;
     };
+
+    typedef InverseCompositionalT<double> InverseCompositional;
+    typedef InverseCompositionalT<float> InverseCompositionalF;
 }
 
 #endif //__TRACKER_INVERSE_COMPOSITIONAL_HPP__
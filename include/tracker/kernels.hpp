@@ -0,0 +1,94 @@
+#ifndef __TRACKER_KERNELS_HPP__
+#define __TRACKER_KERNELS_HPP__
+
+#include <string>
+#include <vector>
+
+namespace Stick {
+    // row kernels of the inverse compositional hot loops.
+    // every instruction set gets its own table, the fastest one the cpu supports is bound at startup.
+    // all tables give identical results: no FMA, and reductions sum into 8 interleaved lanes.
+    namespace Kernels {
+        // pixels per tile of the tiled steepest descent layout, the same as the reduction lanes
+        const int TileSize = 8;
+
+        struct Table {
+            const char* name;
+
+            // central differences of the inner pixels, the first and last pixels are set to zero
+            void (*gradientRow)(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+                    int width, double scale, double* dx, double* dy);
+            // out = jx * dx + jy * dy
+            void (*steepestRow)(const double* jx, const double* jy, const double* dx, const double* dy, int width, double* out);
+            // error = (sampled - reference) * scale
+            void (*errorRow)(const double* sampled, const unsigned char* reference, int width, double scale, double* error);
+            // lane k sums the products x%8 == k, then ((l0+l4)+(l2+l6)) + ((l1+l5)+(l3+l7))
+            double (*dot)(const double* a, const double* b, int width);
+            // lanes[p*8 + k] += tiles[(t*params + p)*8 + k] * error[t*8 + k] over the tiles t < count, so lane k of
+            // every parameter sums like dot() on the untiled values and reduceLanes() gives the same result
+            void (*tileDot)(const double* tiles, const double* error, int count, int params, double* lanes);
+
+            // single precision versions of the above with twice the values per register,
+            // dot sums the same 8 lanes in float and combines them in double
+            void (*gradientRowFloat)(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+                    int width, float scale, float* dx, float* dy);
+            void (*steepestRowFloat)(const float* jx, const float* jy, const float* dx, const float* dy, int width, float* out);
+            void (*errorRowFloat)(const float* sampled, const unsigned char* reference, int width, float scale, float* error);
+            double (*dotFloat)(const float* a, const float* b, int width);
+            void (*tileDotFloat)(const float* tiles, const float* error, int count, int params, float* lanes);
+        };
+
+        extern const Table Scalar;
+        extern const Table SSE42;
+        extern const Table AVX2;
+        extern const Table AVX512;
+
+        // overloads picking the entry of the scalar type, for code templated on it.
+        // the tables themselves are filled from file local functions of the same names
+        inline void gradientRow(const Table& table, const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+                int width, double scale, double* dx, double* dy) {
+            table.gradientRow(previous, current, next, width, scale, dx, dy);
+        }
+        inline void gradientRow(const Table& table, const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+                int width, double scale, float* dx, float* dy) {
+            table.gradientRowFloat(previous, current, next, width, (float)scale, dx, dy);
+        }
+        inline void steepestRow(const Table& table, const double* jx, const double* jy, const double* dx, const double* dy, int width, double* out) {
+            table.steepestRow(jx, jy, dx, dy, width, out);
+        }
+        inline void steepestRow(const Table& table, const float* jx, const float* jy, const float* dx, const float* dy, int width, float* out) {
+            table.steepestRowFloat(jx, jy, dx, dy, width, out);
+        }
+        inline void errorRow(const Table& table, const double* sampled, const unsigned char* reference, int width, double scale, double* error) {
+            table.errorRow(sampled, reference, width, scale, error);
+        }
+        inline void errorRow(const Table& table, const float* sampled, const unsigned char* reference, int width, double scale, float* error) {
+            table.errorRowFloat(sampled, reference, width, (float)scale, error);
+        }
+        inline double dot(const Table& table, const double* a, const double* b, int width) {
+            return table.dot(a, b, width);
+        }
+        inline double dot(const Table& table, const float* a, const float* b, int width) {
+            return table.dotFloat(a, b, width);
+        }
+
+        inline void tileDot(const Table& table, const double* tiles, const double* error, int count, int params, double* lanes) {
+            table.tileDot(tiles, error, count, params, lanes);
+        }
+        inline void tileDot(const Table& table, const float* tiles, const float* error, int count, int params, float* lanes) {
+            table.tileDotFloat(tiles, error, count, params, lanes);
+        }
+        // the final step of dot() on 8 lanes
+        template<typename T>
+        inline double reduceLanes(const T* lanes) {
+            return (((double)lanes[0] + lanes[4]) + ((double)lanes[2] + lanes[6])) + (((double)lanes[1] + lanes[5]) + ((double)lanes[3] + lanes[7]));
+        }
+
+        const Table& get();
+        std::vector<const Table*> getAvailable();
+        // binds an available table by name before tracking starts, returns false if the cpu lacks it
+        bool select(const std::string& name);
+    }
+}
+
+#endif //__TRACKER_KERNELS_HPP__
@@ -0,0 +1,57 @@
+#ifndef __TRACKER_MULTI_TRACKER_HPP__
+#define __TRACKER_MULTI_TRACKER_HPP__
+
+#include <vector>
+#include <functional>
+#include <opencv2/opencv.hpp>
+#include <utils/string.hpp>
+#include <utils/type.hpp>
+
+#include "tracker/tracker.hpp"
+#include "parallel/thread_pool.hpp"
+
+namespace Stick {
+    // many trackers following their own targets in the same frames.
+    // initialize() and track() run the trackers as tasks on a fixed thread pool, every tracker reads the same frame
+    // and the poses come back in one vector in the order the trackers were added.
+    // the trackers parallelize across targets, their own OpenMP threads are best left at 1
+    class MultiTracker {
+        public:
+            // 0 threads uses one per hardware thread
+            explicit MultiTracker(int threads=0);
+            virtual ~MultiTracker();
+            virtual std::string getName() const {
+                std::string className = instant::Utils::Type::GetTypeName(this);
+                return instant::Utils::String::Replace(className, "Stick::", "");
+            }
+
+            // takes ownership like Tracker does of its model, returns the index of the tracker
+            int add(Tracker* tracker);
+            Tracker* get(int index) const;
+            int size() const {
+                return (int)this->trackers.size();
+            }
+            int getThreads() const {
+                return this->pool.getThreads();
+            }
+
+            void initialize();
+            void track(const cv::Mat& image, const double scale=1.0);
+            // pose of every tracker after the last track()
+            const std::vector<cv::Matx33d>& getPoses() const {
+                return this->poses;
+            }
+
+        protected:
+            ThreadPool pool;
+            std::vector<Tracker*> trackers;
+            std::vector<cv::Matx33d> poses;
+
+            // arguments of the running track(), read by trackTask, which is built once so a frame does not allocate
+            const cv::Mat* frame;
+            double scale;
+            std::function<void(int)> trackTask;
+    };
+}
+
+#endif //__TRACKER_MULTI_TRACKER_HPP__
@@ -0,0 +1,46 @@
+#ifndef __TRACKER_SAMPLING_HPP__
+#define __TRACKER_SAMPLING_HPP__
+
+#include <cmath>
+#include <opencv2/opencv.hpp>
+
+namespace Stick {
+    // bilinear sample with a zero border, matching warpPerspective(BORDER_CONSTANT)
+    inline double sampleBilinear(const cv::Mat& image, double x, double y) {
+        if( !(x > -1.0 && y > -1.0 && x < image.cols && y < image.rows) ) {
+            return 0.0;
+        }
+        int x0 = (int)std::floor(x);
+        int y0 = (int)std::floor(y);
+        double ax = x - x0;
+        double ay = y - y0;
+
+        double v00 = 0.0, v01 = 0.0, v10 = 0.0, v11 = 0.0;
+        if( x0 >= 0 && y0 >= 0 && x0+1 < image.cols && y0+1 < image.rows ) {
+            const unsigned char* row = image.ptr<unsigned char>(y0) + x0;
+            v00 = row[0];
+            v01 = row[1];
+            v10 = row[image.step];
+            v11 = row[image.step+1];
+        } else {
+            bool top = y0 >= 0, bottom = y0+1 < image.rows;
+            bool left = x0 >= 0, right = x0+1 < image.cols;
+            if( top && left )     v00 = image.at<unsigned char>(y0, x0);
+            if( top && right )    v01 = image.at<unsigned char>(y0, x0+1);
+            if( bottom && left )  v10 = image.at<unsigned char>(y0+1, x0);
+            if( bottom && right ) v11 = image.at<unsigned char>(y0+1, x0+1);
+        }
+        return (v00 * (1.0 - ax) + v01 * ax) * (1.0 - ay) + (v10 * (1.0 - ax) + v11 * ax) * ay;
+    }
+
+    // samples image at the homography h (row major 3x3) applied to (x, y)
+    inline double sampleWarped(const cv::Mat& image, const double* h, double x, double y) {
+        double z = h[6]*x + h[7]*y + h[8];
+        z = z ? 1.0/z : 0.0;
+        double sx = (h[0]*x + h[1]*y + h[2]) * z;
+        double sy = (h[3]*x + h[4]*y + h[5]) * z;
+        return sampleBilinear(image, sx, sy);
+    }
+}
+
+#endif //__TRACKER_SAMPLING_HPP__
@@ -0,0 +1,33 @@
+#ifndef __TRACKER_TEMPLATE_CACHE_HPP__
+#define __TRACKER_TEMPLATE_CACHE_HPP__
+
+#include <string>
+#include <memory>
+#include <stdint.h>
+#include <opencv2/opencv.hpp>
+
+#include "tracker/template_data.hpp"
+
+namespace Stick {
+    // TemplateData persisted to a versioned binary file, so a restarted tracker skips the precomputation.
+    // the file holds a header (magic, version, byte order, key, model, scalar type, pixel fraction) followed by
+    // every level with its matrices aligned to cache lines. Load() maps the file read only and the matrices of the
+    // returned data point into the mapping, which stays mapped as long as the data or any copy of it lives
+    class TemplateCache {
+        public:
+            static const uint32_t Version = 1;
+
+            // FNV-1a over the template size and pixels, continued over the configuration string,
+            // so a changed template or tracker setting gives another key
+            static uint64_t Hash(const cv::Mat& image, const std::string& configuration="");
+
+            // writes to a temporary file renamed over path, readers mapping the previous file keep it intact
+            static void Save(const std::string& path, const TemplateData& templateData, uint64_t key);
+            // empty when the file does not exist, is of another version or byte order, or was saved under another key.
+            // throws InvalidParameters when the file is truncated or malformed, or a matrix does not fit the template size,
+            // the tracked pixels and the parameters
+            static std::shared_ptr<const TemplateData> Load(const std::string& path, uint64_t key);
+    };
+}
+
+#endif //__TRACKER_TEMPLATE_CACHE_HPP__
@@ -0,0 +1,73 @@
+#ifndef __TRACKER_TEMPLATE_DATA_HPP__
+#define __TRACKER_TEMPLATE_DATA_HPP__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <opencv2/opencv.hpp>
+
+#include "tracker/kernels.hpp"
+
+namespace Stick {
+    // one resolution of the template pyramid, gradients and steepest hold the scalar type of the tracker
+    struct TrackingLevel {
+        double scale;
+        cv::Mat templateImage;
+        cv::Mat gradients;
+        cv::Mat hessianInv;
+
+        // steepest descent images in tiles of Kernels::TileSize pixels, one tile per matrix row.
+        // the tracked pixels are split in blocks of template width (template rows, or rows of the compact pixel list),
+        // every block into getTilesPerRow() tiles holding the values of each parameter next to each other,
+        // zero padded past the end of the block. the sums of a pixel block read contiguous memory
+        cv::Mat steepest;
+
+        // warp jacobians of the tracked pixels, row 2*p+r holds d(x, y)[r]/dp. only built for ESM
+        cv::Mat jacobians;
+
+        // selected pixels in row major order with their template values, empty when every pixel is tracked.
+        // steepest then only holds these pixels
+        std::vector<int> pixels;
+        std::vector<unsigned char> reference;
+
+        int getCount() const {
+            return this->pixels.empty() ? this->templateImage.size().area() : (int)this->pixels.size();
+        }
+        int getTilesPerRow() const {
+            return (this->templateImage.size().width + Kernels::TileSize - 1) / Kernels::TileSize;
+        }
+        // value of parameter p at the i-th tracked pixel
+        template<typename T>
+        T steepestAt(int p, int i) const {
+            int width = this->templateImage.size().width;
+            int column = i % width;
+            int tile = (i / width) * this->getTilesPerRow() + column / Kernels::TileSize;
+            return this->steepest.ptr<T>(tile)[p*Kernels::TileSize + column % Kernels::TileSize];
+        }
+    };
+
+    // everything initialize() precomputes from a template image, for one model and scalar type.
+    // trackers hold it through std::shared_ptr<const TemplateData> and never change it once built,
+    // so any number of trackers, in any threads, can follow the same template off a single copy
+    struct TemplateData {
+        TemplateData() {
+            this->parameterSize = 0;
+            this->depth = -1;
+            this->pixelFraction = 1.0;
+        }
+
+        std::vector<TrackingLevel> levels;
+
+        // what the data was built for, checked when a tracker takes it
+        std::string modelName;
+        int parameterSize;
+        int depth;
+        double pixelFraction;
+
+        // whatever the matrices point into besides their own buffers, like the mapping of a loaded cache file.
+        // copies share it, so they stay valid after the data they were copied from is gone
+        std::shared_ptr<const void> owner;
+    };
+}
+
+#endif //__TRACKER_TEMPLATE_DATA_HPP__
@@ -6,6 +6,7 @@
 #include <utils/type.hpp>
 
 #include "model/model.hpp"
+#include "predictor/predictor.hpp"
 #include "exceptions/invalid_parameters.hpp"
 
 namespace Stick {
@@ -13,12 +14,15 @@ namespace Stick {
         protected:
             Tracker(Model* model) {
                 this->model = model;
+                this->predictor = NULL;
             }
 
         public:
             virtual ~Tracker() {
                 if(this->model) delete this->model;
                 this->model = NULL;
+                if(this->predictor) delete this->predictor;
+                this->predictor = NULL;
             }
             virtual std::string getName() const {
                 std::string className = instant::Utils::Type::GetTypeName(this);
@@ -29,7 +33,8 @@ namespace Stick {
                 if(image.channels() != 1) {
                     throw MakeClassException(InvalidParameters, "template image must be a single channel");
                 }
-                image.copyTo( this->templateImage );
+                // always a new buffer, template data built from the previous image may share it
+                this->templateImage = image.clone();
             }
             const cv::Mat getTemplateImage() const {
                 return this->templateImage.clone();
@@ -51,16 +56,45 @@ namespace Stick {
             Model* getModel() const {
                 return this->model;
             }
+            // takes ownership like the model, NULL starts every frame from the last pose
+            void setPredictor(Predictor* predictor) {
+                if(this->predictor) delete this->predictor;
+                this->predictor = predictor;
+            }
+            Predictor* getPredictor() const {
+                return this->predictor;
+            }
 
             virtual void initialize() = 0;
             virtual void track(const cv::Mat& image, const double scale) = 0;
             virtual std::vector<cv::Mat> getPoseTrace() const = 0;
             virtual std::string getLogString() const = 0;
 
+        protected:
+            // called by track() around the optimization of a frame
+            void predictPose() {
+                if( this->predictor ) {
+                    this->predictedPose = this->predictor->predict(this->model->getMatx());
+                    this->model->setMatx(this->predictedPose);
+                }
+            }
+            void updatePredictor() {
+                if( this->predictor ) {
+                    this->predictor->update(this->model->getMatx());
+                }
+            }
+            // translation between the predicted and the converged pose of the last frame
+            double getPredictionError() const {
+                cv::Matx33d pose = this->model->getMatx();
+                return std::sqrt(std::pow(pose(0, 2) - this->predictedPose(0, 2), 2.0) + std::pow(pose(1, 2) - this->predictedPose(1, 2), 2.0));
+            }
+
         protected:
             cv::Mat templateImage;
             cv::Mat transformedImage;
             Model* model;
+            Predictor* predictor;
+            cv::Matx33d predictedPose;
     };
 }
 
@@ -0,0 +1,439 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#include <utils/string.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <tracker/inverse_compositional.hpp>
+#include <tracker/esm.hpp>
+#include <parallel/thread_pool.hpp>
+#include <model/homography.hpp>
+#include <model/affine.hpp>
+#include <model/similarity.hpp>
+#include <model/euclidean.hpp>
+#include <model/translation.hpp>
+
+void help(char* execute) {
+    std::cerr << "usage: " << execute << " [-h] -i IMAGE [-c CONFIGURATION ...] [-t TEMPLATE_SIZE] [-g GAUSSIAN_KERNAL_SIZE] [-m MAGNITUDES] [-n TRIALS] [-T THRESHOLD] [-s SEED] [-w WORKERS] [-o OUTPUT] [-S SUMMARY] [-v]" << std::endl;
+    std::cerr << "" << std::endl;
+    std::cerr << "\t-h, --help                           show this help message and exit" << std::endl;
+    std::cerr << "\t-i, --image     IMAGE                track perturbations of the center of IMAGE, like test/datas/im000.png" << std::endl;
+    std::cerr << "\t-c, --config    CONFIGURATION        compare a tracker CONFIGURATION, repeated for more (default:algorithm=ic)" << std::endl;
+    std::cerr << "\t                                     key=value pairs joined by ':' of algorithm ic|esm, type double|float," << std::endl;
+    std::cerr << "\t                                     model homography|affine|similarity|euclidean|translation, level, fraction," << std::endl;
+    std::cerr << "\t                                     epsilon, iteration and budget, like algorithm=esm:type=float:level=2" << std::endl;
+    std::cerr << "\t-t, --template  SIZE                 set TEMPLATE_SIZE (default:100)" << std::endl;
+    std::cerr << "\t-g, --gaussian  GAUSSIAN_KERNAL_SIZE blur IMAGE with GAUSSIAN_KERNAL_SIZE, 0 for none (default:5)" << std::endl;
+    std::cerr << "\t-m, --magnitude MAGNITUDES           comma separated standard deviations of the corner displacements in pixels (default:1,2,4,6,8,10)" << std::endl;
+    std::cerr << "\t-n, --trials    TRIALS               track TRIALS perturbations per magnitude (default:1000)" << std::endl;
+    std::cerr << "\t-T, --threshold THRESHOLD            a trial converged when its rms corner error is below THRESHOLD pixels (default:1.0)" << std::endl;
+    std::cerr << "\t-s, --seed      SEED                 set the SEED of the perturbations (default:1)" << std::endl;
+    std::cerr << "\t-w, --workers   WORKERS              track on WORKERS threads, 0 for one per hardware thread, 1 for undisturbed times (default:0)" << std::endl;
+    std::cerr << "\t-o, --output    OUTPUT               write every trial to the OUTPUT csv" << std::endl;
+    std::cerr << "\t-S, --summary   SUMMARY              write the summary of every configuration and magnitude to the SUMMARY csv" << std::endl;
+    std::cerr << "\t-v, --verbose                        verbose" << std::endl;
+    exit(-1);
+}
+
+struct Configuration {
+    Configuration() {
+        this->algorithm = "ic";
+        this->type = "double";
+        this->modelName = "homography";
+        this->pyramidLevel = 1;
+        this->pixelFraction = 1.0;
+        this->epsilon = 0.05;
+        this->iteration = 100;
+        this->timeBudget = 0.0;
+    }
+
+    // as given on the command line
+    std::string name;
+    std::string algorithm;
+    std::string type;
+    std::string modelName;
+    int pyramidLevel;
+    double pixelFraction;
+    double epsilon;
+    int iteration;
+    double timeBudget;
+};
+
+// false for an unknown key
+bool parseConfiguration(const std::string& text, Configuration& configuration) {
+    configuration.name = text;
+    std::stringstream stream(text);
+    std::string pair;
+    while( std::getline(stream, pair, ':') ) {
+        size_t equal = pair.find('=');
+        if( equal == std::string::npos ) {
+            return false;
+        }
+        std::string key = pair.substr(0, equal);
+        std::string value = pair.substr(equal + 1);
+        if( key == "algorithm" ) {
+            configuration.algorithm = value;
+        } else if( key == "type" ) {
+            configuration.type = value;
+        } else if( key == "model" ) {
+            configuration.modelName = value;
+        } else if( key == "level" ) {
+            instant::Utils::String::ToPrimitive<int>(value, configuration.pyramidLevel);
+        } else if( key == "fraction" ) {
+            instant::Utils::String::ToPrimitive<double>(value, configuration.pixelFraction);
+        } else if( key == "epsilon" ) {
+            instant::Utils::String::ToPrimitive<double>(value, configuration.epsilon);
+        } else if( key == "iteration" ) {
+            instant::Utils::String::ToPrimitive<int>(value, configuration.iteration);
+        } else if( key == "budget" ) {
+            instant::Utils::String::ToPrimitive<double>(value, configuration.timeBudget);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// NULL for an unknown model name
+Stick::Model* createModel(const std::string& modelName) {
+    if( modelName == "homography" ) {
+        return new Stick::Homography();
+    } else if( modelName == "affine" ) {
+        return new Stick::Affine();
+    } else if( modelName == "similarity" ) {
+        return new Stick::Similarity();
+    } else if( modelName == "euclidean" ) {
+        return new Stick::Euclidean();
+    } else if( modelName == "translation" ) {
+        return new Stick::Translation();
+    }
+    return NULL;
+}
+
+template<typename T>
+Stick::Tracker* createTracker(const Configuration& configuration) {
+    Stick::Model* model = createModel(configuration.modelName);
+    if( model == NULL ) {
+        return NULL;
+    }
+    Stick::InverseCompositionalT<T>* tracker = NULL;
+    if( configuration.algorithm == "ic" ) {
+        tracker = new Stick::InverseCompositionalT<T>(model, configuration.epsilon, configuration.iteration, configuration.pyramidLevel);
+    } else if( configuration.algorithm == "esm" ) {
+        tracker = new Stick::ESMT<T>(model, configuration.epsilon, configuration.iteration, configuration.pyramidLevel);
+    } else {
+        delete model;
+        return NULL;
+    }
+    tracker->setPixelFraction( configuration.pixelFraction );
+    tracker->setTimeBudget( configuration.timeBudget );
+    return tracker;
+}
+
+// NULL for an unknown algorithm, type or model
+Stick::Tracker* createTracker(const Configuration& configuration) {
+    if( configuration.type == "double" ) {
+        return createTracker<double>(configuration);
+    } else if( configuration.type == "float" ) {
+        return createTracker<float>(configuration);
+    }
+    return NULL;
+}
+
+// iterations of the last track(), 0 for trackers that do not count them
+int getIterations(const Stick::Tracker* tracker) {
+    if( const Stick::InverseCompositional* inverseCompositional = dynamic_cast<const Stick::InverseCompositional*>(tracker) ) {
+        return inverseCompositional->getIterations();
+    }
+    if( const Stick::InverseCompositionalF* inverseCompositional = dynamic_cast<const Stick::InverseCompositionalF*>(tracker) ) {
+        return inverseCompositional->getIterations();
+    }
+    return 0;
+}
+
+// the template is the center of the image, as Tracker::calculateTransformedImage takes it. a perturbation moves
+// its corners by normally distributed offsets and warps the image by the homography between the corners, so
+// the corners a tracker should find are the moved ones
+class Perturbation {
+    public:
+        // the same perturbation for a seed, magnitude and trial on every platform and in any order:
+        // mt19937 and seed_seq are fully specified, the distributions of <random> are not
+        Perturbation(const cv::Mat& image, const cv::Size& templateSize, unsigned seed, int magnitude, int trial, double sigma) {
+            std::seed_seq sequence{seed, (unsigned)magnitude, (unsigned)trial};
+            std::mt19937 random(sequence);
+
+            this->offset = cv::Point2f(image.cols/2 - templateSize.width/2, image.rows/2 - templateSize.height/2);
+            cv::Point2f corners[4] = {cv::Point2f(0, 0), cv::Point2f(templateSize.width, 0),
+                                      cv::Point2f(templateSize.width, templateSize.height), cv::Point2f(0, templateSize.height)};
+            cv::Point2f original[4];
+            double squared = 0.0;
+            for(int c=0; c<4; c++) {
+                // box muller on (0, 1] uniforms
+                double u = (random() + 1.0) / 4294967296.0;
+                double v = (random() + 1.0) / 4294967296.0;
+                double radius = sigma * std::sqrt(-2.0 * std::log(u));
+                cv::Point2f moved(radius * std::cos(2.0 * M_PI * v), radius * std::sin(2.0 * M_PI * v));
+
+                this->corners[c] = corners[c];
+                original[c] = corners[c] + this->offset;
+                this->moved[c] = original[c] + moved;
+                squared += moved.x * moved.x + moved.y * moved.y;
+            }
+            this->initialError = std::sqrt(squared / 4.0);
+            cv::warpPerspective(image, this->frame, cv::getPerspectiveTransform(original, this->moved), image.size());
+        }
+
+        // rms distance between the moved corners and the template corners placed by the tracker pose,
+        // offset to the image center like the tracker does
+        double getError(const Stick::Tracker& tracker) const {
+            cv::Matx33d pose = tracker.getModel()->getMatx();
+            pose(0, 2) += this->offset.x;
+            pose(1, 2) += this->offset.y;
+            double squared = 0.0;
+            for(int c=0; c<4; c++) {
+                cv::Vec3d placed = pose * cv::Vec3d(this->corners[c].x, this->corners[c].y, 1.0);
+                double dx = placed[0]/placed[2] - this->moved[c].x;
+                double dy = placed[1]/placed[2] - this->moved[c].y;
+                squared += dx*dx + dy*dy;
+            }
+            return std::sqrt(squared / 4.0);
+        }
+
+        cv::Mat frame;
+        double initialError;
+
+    protected:
+        cv::Point2f offset;
+        cv::Point2f corners[4];
+        cv::Point2f moved[4];
+};
+
+struct Trial {
+    Trial() : initialError(0.0), error(0.0), iterations(0), time(0.0) {
+    }
+
+    double initialError;
+    double error;
+    int iterations;
+    double time;
+};
+
+int main(int argc, char* argv[]) {
+    static struct option longOptions[] = {
+        {"help",      no_argument,       0, 'h'},
+        {"image",     required_argument, 0, 'i'},
+        {"config",    required_argument, 0, 'c'},
+        {"template",  required_argument, 0, 't'},
+        {"gaussian",  required_argument, 0, 'g'},
+        {"magnitude", required_argument, 0, 'm'},
+        {"trials",    required_argument, 0, 'n'},
+        {"threshold", required_argument, 0, 'T'},
+        {"seed",      required_argument, 0, 's'},
+        {"workers",   required_argument, 0, 'w'},
+        {"output",    required_argument, 0, 'o'},
+        {"summary",   required_argument, 0, 'S'},
+        {"verbose",   no_argument,       0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    std::string imagePath;
+    std::vector<Configuration> configurations;
+    int templateSize = 100;
+    int gaussianBlurSize = 5;
+    std::vector<double> magnitudes;
+    int trials = 1000;
+    double threshold = 1.0;
+    unsigned seed = 1;
+    int workers = 0;
+    std::string outputPath;
+    std::string summaryPath;
+    bool verbose = false;
+
+    int argopt, optionIndex=0;
+    while( (argopt = getopt_long(argc, argv, "hi:c:t:g:m:n:T:s:w:o:S:v", longOptions, &optionIndex)) != -1 ) {
+        switch( argopt ) {
+            case 'i':
+                imagePath = std::string(optarg);
+                break;
+            case 'c': {
+                Configuration configuration;
+                if( !parseConfiguration(optarg, configuration) ) {
+                    help(argv[0]);
+                }
+                configurations.push_back(configuration);
+                break;
+            }
+            case 't':
+                instant::Utils::String::ToPrimitive<int>(optarg, templateSize);
+                break;
+            case 'g':
+                instant::Utils::String::ToPrimitive<int>(optarg, gaussianBlurSize);
+                break;
+            case 'm': {
+                std::stringstream stream(optarg);
+                std::string magnitude;
+                while( std::getline(stream, magnitude, ',') ) {
+                    magnitudes.push_back(atof(magnitude.c_str()));
+                }
+                break;
+            }
+            case 'n':
+                instant::Utils::String::ToPrimitive<int>(optarg, trials);
+                break;
+            case 'T':
+                instant::Utils::String::ToPrimitive<double>(optarg, threshold);
+                break;
+            case 's':
+                instant::Utils::String::ToPrimitive<unsigned>(optarg, seed);
+                break;
+            case 'w':
+                instant::Utils::String::ToPrimitive<int>(optarg, workers);
+                break;
+            case 'o':
+                outputPath = std::string(optarg);
+                break;
+            case 'S':
+                summaryPath = std::string(optarg);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'h':
+            default:
+                help(argv[0]);
+                break;
+        }
+    }
+    if( imagePath.empty() || trials <= 0 ) {
+        help(argv[0]);
+    }
+    if( configurations.empty() ) {
+        configurations.resize(1);
+        parseConfiguration("algorithm=ic", configurations[0]);
+    }
+    if( magnitudes.empty() ) {
+        double defaults[] = {1, 2, 4, 6, 8, 10};
+        magnitudes.assign(defaults, defaults + 6);
+    }
+    for(const Configuration& configuration : configurations) {
+        Stick::Tracker* check = createTracker(configuration);
+        if( check == NULL ) {
+            std::cerr << "unknown configuration " << configuration.name << std::endl;
+            help(argv[0]);
+        }
+        delete check;
+    }
+
+    cv::Mat image = cv::imread(imagePath, CV_LOAD_IMAGE_GRAYSCALE);
+    if( image.empty() ) {
+        std::cerr << "cannot read " << imagePath << std::endl;
+        return -1;
+    }
+    if( gaussianBlurSize > 0 ) {
+        cv::Mat blurred;
+        cv::GaussianBlur(image, blurred, cv::Size(gaussianBlurSize, gaussianBlurSize), gaussianBlurSize/2.0, gaussianBlurSize/2.0);
+        image = blurred;
+    }
+    cv::Size size(templateSize, templateSize);
+
+    std::ofstream output, summary;
+    if( !outputPath.empty() ) {
+        output.open(outputPath.c_str());
+        if( !output ) {
+            std::cerr << "cannot write " << outputPath << std::endl;
+            return -1;
+        }
+        output << "config,magnitude,trial,initial_error,error,converged,iterations,time_ms" << std::endl;
+    }
+    if( !summaryPath.empty() ) {
+        summary.open(summaryPath.c_str());
+        if( !summary ) {
+            std::cerr << "cannot write " << summaryPath << std::endl;
+            return -1;
+        }
+        summary << "config,magnitude,trials,converged_rate,mean_converged_error,median_error,mean_iterations,mean_time_ms" << std::endl;
+    }
+
+    // trials are tracked in chunks, every chunk on a tracker of its own built once, so the template
+    // precomputation is not timed. a trial only depends on its seed, not on the chunk or worker
+    Stick::ThreadPool pool(workers);
+    int count = (int)magnitudes.size() * trials;
+    int chunks = std::min(count, pool.getThreads() * 4);
+    std::cout << instant::Utils::String::Format("%-40s %9s %10s %10s %10s %8s %10s",
+            "config", "magnitude", "converged", "error", "median", "iters", "time_ms") << std::endl;
+    for(const Configuration& configuration : configurations) {
+        std::vector<Trial> results(count);
+        pool.run(chunks, [&](int chunk) {
+            Stick::Tracker* tracker = createTracker(configuration);
+            tracker->calculateTransformedImage(image, size);
+            tracker->setTemplateImage( tracker->getTransformedImage() );
+            tracker->initialize();
+
+            for(int i=chunk*count/chunks; i<(chunk+1)*count/chunks; i++) {
+                int magnitude = i / trials;
+                Perturbation perturbation(image, size, seed, magnitude, i % trials, magnitudes[magnitude]);
+
+                tracker->getModel()->initialize();
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                tracker->track(perturbation.frame, 1.0);
+                double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                Trial& trial = results[i];
+                trial.initialError = perturbation.initialError;
+                trial.error = perturbation.getError(*tracker);
+                trial.iterations = getIterations(tracker);
+                trial.time = time;
+            }
+            delete tracker;
+        });
+
+        for(int m=0; m<(int)magnitudes.size(); m++) {
+            int converged = 0, iterations = 0;
+            double convergedError = 0.0, time = 0.0;
+            std::vector<double> errors;
+            for(int t=0; t<trials; t++) {
+                const Trial& trial = results[m*trials + t];
+                bool success = trial.error < threshold;
+                converged += success ? 1 : 0;
+                convergedError += success ? trial.error : 0.0;
+                iterations += trial.iterations;
+                time += trial.time;
+                errors.push_back(trial.error);
+
+                if( output.is_open() ) {
+                    output << configuration.name << "," << magnitudes[m] << "," << t
+                           << instant::Utils::String::Format(",%.6f,%.6f,%d,%d,%.4f", trial.initialError, trial.error,
+                                   success ? 1 : 0, trial.iterations, trial.time) << std::endl;
+                }
+                if( verbose ) {
+                    std::cout << instant::Utils::String::Format("%s magnitude:%g, trial:%d, error:%.3f->%.3fpx, iterations:%d, time=%.3fms",
+                            configuration.name.c_str(), magnitudes[m], t, trial.initialError, trial.error, trial.iterations, trial.time) << std::endl;
+                }
+            }
+            std::nth_element(errors.begin(), errors.begin() + trials/2, errors.end());
+            double median = errors[trials/2];
+            double rate = (double)converged / trials;
+            double meanConvergedError = converged > 0 ? convergedError / converged : 0.0;
+
+            std::cout << instant::Utils::String::Format("%-40s %9g %9.1f%% %10.4f %10.4f %8.2f %10.3f",
+                    configuration.name.c_str(), magnitudes[m], rate * 100.0, meanConvergedError, median,
+                    (double)iterations / trials, time / trials) << std::endl;
+            if( summary.is_open() ) {
+                summary << configuration.name << "," << magnitudes[m] << "," << trials
+                        << instant::Utils::String::Format(",%.6f,%.6f,%.6f,%.4f,%.4f", rate, meanConvergedError, median,
+                                (double)iterations / trials, time / trials) << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
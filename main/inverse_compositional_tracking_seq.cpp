@@ -1,8 +1,13 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <cstdlib>
 #include <getopt.h>
 #include <string>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
 
 #include <utils/string.hpp>
 #include <utils/filesystem.hpp>
@@ -10,22 +15,320 @@
 #include <opencv2/opencv.hpp>
 
 #include <tracker/inverse_compositional.hpp>
+#include <tracker/esm.hpp>
+#include <parallel/ordered_queue.hpp>
+#include <parallel/thread_pool.hpp>
+#include <io/packed_sequence.hpp>
 #include <model/homography.hpp>
+#include <model/affine.hpp>
+#include <model/similarity.hpp>
+#include <model/euclidean.hpp>
+#include <model/translation.hpp>
+#include <predictor/constant_velocity.hpp>
+#include <predictor/constant_acceleration.hpp>
+#include <predictor/kalman.hpp>
 
 void help(char* execute) {
-    std::cerr << "usage: " << execute << " [-h] -p DATA_PATH [-t TEMPLATE_SIZE] [-g GAUSSIAN_KERNAL_SIZE] [-e EPSILON_VALUE] [-k ITERATION] [-b] [-v]" << std::endl;
+    std::cerr << "usage: " << execute << " [-h] -p DATA_PATH [-p DATA_PATH ...] [-t TEMPLATE_SIZE] [-g GAUSSIAN_KERNAL_SIZE] [-e EPSILON_VALUE] [-k ITERATION] [-l PYRAMID_LEVEL] [-j THREADS] [-m MODEL] [-f PIXEL_FRACTION] [-P PREDICTOR] [-S] [-a ALGORITHM] [-B BUDGET] [-A] [-C CACHE_PATH] [-R MARGIN] [-D DECODERS] [-Q QUEUE_SIZE] [-H] [-o OUTPUT] [-w WORKERS] [-b] [-v]" << std::endl;
     std::cerr << "" << std::endl;
     std::cerr << "\t-h, --help                           show this help message and exit" << std::endl;
-    std::cerr << "\t-p, --path      DATA_PATH            set DATA_PATH" << std::endl;
+    std::cerr << "\t-p, --path      DATA_PATH            set DATA_PATH, a directory of images or a packed sequence, repeated for more sequences in headless mode" << std::endl;
     std::cerr << "\t-t, --template  SIZE                 set TEMPLATE_SIZE (default:200)" << std::endl;
     std::cerr << "\t-g, --gaussian  GAUSSIAN_KERNAL_SIZE set GAUSSIAN_KERNAL_SIZE (default:21)" << std::endl;
     std::cerr << "\t-e, --epsilon   EPSILON_VALUE        set EPSILON_VALUE (default:0.05)" << std::endl;
     std::cerr << "\t-k, --iteration ITERATION            set max ITERATION per update (default:100)" << std::endl;
+    std::cerr << "\t-l, --level     PYRAMID_LEVEL        set coarse-to-fine PYRAMID_LEVEL (default:1)" << std::endl;
+    std::cerr << "\t-j, --threads   THREADS              set THREADS per tracker, needs ENABLE_OPENMP (default:1)" << std::endl;
+    std::cerr << "\t-m, --model     MODEL                set MODEL homography|affine|similarity|euclidean|translation (default:homography)" << std::endl;
+    std::cerr << "\t-f, --fraction  PIXEL_FRACTION       track only the PIXEL_FRACTION of strongest template pixels (default:1.0)" << std::endl;
+    std::cerr << "\t-P, --predictor PREDICTOR            set PREDICTOR none|velocity|acceleration|kalman (default:none)" << std::endl;
+    std::cerr << "\t-S, --saved                          also track every frame without the prediction to report the iterations PREDICTOR saves" << std::endl;
+    std::cerr << "\t-a, --algorithm ALGORITHM            set tracking ALGORITHM ic|esm (default:ic)" << std::endl;
+    std::cerr << "\t-B, --budget    BUDGET               stop iterating a frame after BUDGET milliseconds, 0 for none (default:0)" << std::endl;
+    std::cerr << "\t-A, --adaptive                       cap the iterations by the recent converged frames" << std::endl;
+    std::cerr << "\t-C, --cache     CACHE_PATH           load the template data from CACHE_PATH, or build and save it there (CACHE_PATH.N for sequence N of many)" << std::endl;
+    std::cerr << "\t-R, --region    MARGIN               blur and track only the predicted template region grown by MARGIN pixels, 0 for the whole frame (default:32)" << std::endl;
+    std::cerr << "\t-D, --decoders  DECODERS             decode and preprocess upcoming frames on DECODERS threads (default:2)" << std::endl;
+    std::cerr << "\t-Q, --queue     QUEUE_SIZE           hold at most QUEUE_SIZE decoded frames ahead of tracking (default:4)" << std::endl;
+    std::cerr << "\t-H, --headless                       no windows and no playback pacing, as fast as possible" << std::endl;
+    std::cerr << "\t-o, --output    OUTPUT               write pose, iterations, delta, status and time of every frame to the OUTPUT csv" << std::endl;
+    std::cerr << "\t-w, --workers   WORKERS              track WORKERS sequences at once in headless mode, 0 for one per hardware thread (default:0)" << std::endl;
     std::cerr << "\t-b, --break;                         break wait iter" << std::endl;
     std::cerr << "\t-v, --verbose                        verbose" << std::endl;
     exit(-1);
 }
 
+struct Options {
+    Options() {
+        this->templateSize = 200;
+        this->epsilon = 0.05;
+        this->iteration = 100;
+        this->gaussianBlurSize = 21;
+        this->pyramidLevel = 1;
+        this->threads = 1;
+        this->modelName = "homography";
+        this->pixelFraction = 1.0;
+        this->predictorName = "none";
+        this->measurePrediction = false;
+        this->algorithm = "ic";
+        this->timeBudget = 0.0;
+        this->adaptive = false;
+        this->regionMargin = 32;
+        this->decoderCount = 2;
+        this->queueSize = 4;
+        this->headless = false;
+        this->workers = 0;
+        this->breakIter = false;
+        this->verbose = false;
+    }
+
+    std::vector<std::string> dataPaths;
+    int templateSize;
+    float epsilon;
+    int iteration;
+    int gaussianBlurSize;
+    int pyramidLevel;
+    int threads;
+    std::string modelName;
+    double pixelFraction;
+    std::string predictorName;
+    bool measurePrediction;
+    std::string algorithm;
+    double timeBudget;
+    bool adaptive;
+    std::string cachePath;
+    int regionMargin;
+    int decoderCount;
+    int queueSize;
+    bool headless;
+    std::string outputPath;
+    int workers;
+    bool breakIter;
+    bool verbose;
+};
+
+// what one sequence took, with its csv rows when asked for
+struct Result {
+    Result() : frames(0), iterations(0), savedIterations(0), trackingTime(0.0), totalTime(0.0) {
+    }
+
+    int frames;
+    int iterations;
+    int savedIterations;
+    double trackingTime;
+    double totalTime;
+    std::string name;
+    std::string rows;
+};
+
+// NULL for an unknown model, predictor or algorithm name
+Stick::InverseCompositional* createTracker(const Options& options) {
+    Stick::Model* model = NULL;
+    if( options.modelName == "homography" ) {
+        model = new Stick::Homography();
+    } else if( options.modelName == "affine" ) {
+        model = new Stick::Affine();
+    } else if( options.modelName == "similarity" ) {
+        model = new Stick::Similarity();
+    } else if( options.modelName == "euclidean" ) {
+        model = new Stick::Euclidean();
+    } else if( options.modelName == "translation" ) {
+        model = new Stick::Translation();
+    } else {
+        return NULL;
+    }
+
+    Stick::Predictor* predictor = NULL;
+    if( options.predictorName == "velocity" ) {
+        predictor = new Stick::ConstantVelocity();
+    } else if( options.predictorName == "acceleration" ) {
+        predictor = new Stick::ConstantAcceleration();
+    } else if( options.predictorName == "kalman" ) {
+        predictor = new Stick::Kalman();
+    } else if( options.predictorName != "none" ) {
+        delete model;
+        return NULL;
+    }
+
+    Stick::InverseCompositional* tracker = NULL;
+    if( options.algorithm == "ic" ) {
+        tracker = new Stick::InverseCompositional(model, options.epsilon, options.iteration, options.pyramidLevel);
+    } else if( options.algorithm == "esm" ) {
+        tracker = new Stick::ESM(model, options.epsilon, options.iteration, options.pyramidLevel);
+    } else {
+        delete model;
+        delete predictor;
+        return NULL;
+    }
+    tracker->setKeepDebugImages( options.verbose && !options.headless );
+    tracker->setThreads( options.threads );
+    tracker->setPixelFraction( options.pixelFraction );
+    tracker->setPredictor( predictor );
+    tracker->setMeasurePrediction( options.measurePrediction );
+    tracker->setTimeBudget( options.timeBudget );
+    tracker->setAdaptiveIterations( options.adaptive );
+    tracker->setRegionMargin( options.regionMargin );
+    return tracker;
+}
+
+// tracks every frame of dataPath with a tracker of its own, showing the frames unless headless
+Result trackSequence(const Options& options, const std::string& dataPath, const std::string& cachePath, bool writeRows) {
+    Result result;
+    result.name = dataPath;
+    std::vector<std::string> filelist;
+    // a packed sequence is replayed from its mapping without decoding
+    std::unique_ptr<Stick::PackedSequence> packed;
+    if( Stick::PackedSequence::IsPackedSequence(dataPath) ) {
+        packed.reset(new Stick::PackedSequence(dataPath));
+        for(size_t f=0; f<packed->getFrameCount(); f++) {
+            filelist.push_back(packed->getFrameName(f));
+        }
+    } else {
+        instant::Utils::Filesystem::GetFileNames(dataPath, filelist);
+    }
+    if( filelist.empty() ) {
+        std::cerr << "no frames in " << dataPath << std::endl;
+        return result;
+    }
+    Stick::InverseCompositional* tracker = createTracker(options);
+    cv::Size templateSize(options.templateSize, options.templateSize);
+
+    // frames are decoded once in color, converted to gray and, when the whole frame is tracked, blurred
+    // on the decoder threads while earlier frames are tracked. a region only depends on the pose of the
+    // frame before, so it is blurred right before tracking. packed frames are gray views on the mapping,
+    // colored only to be shown
+    struct Frame {
+        cv::Mat color;
+        cv::Mat gray;
+    };
+    cv::Size blurSize(options.gaussianBlurSize, options.gaussianBlurSize);
+    double blurSigma = options.gaussianBlurSize/2.0;
+    bool blurFrames = options.regionMargin == 0;
+    Stick::OrderedQueue<Frame> queue(options.queueSize);
+    std::atomic<int> nextFrame(0);
+    std::vector<std::thread> decoders;
+    for(int d=0; d<std::max(1, options.decoderCount); d++) {
+        decoders.push_back(std::thread([&]() {
+            for(int i=nextFrame++; i<(int)filelist.size(); i=nextFrame++) {
+                Frame frame;
+                if( packed ) {
+                    frame.gray = packed->getFrame(i);
+                    if( !options.headless ) {
+                        cv::cvtColor(frame.gray, frame.color, CV_GRAY2BGR);
+                    }
+                } else {
+                    frame.color = cv::imread(filelist[i], CV_LOAD_IMAGE_COLOR);
+                    cv::cvtColor(frame.color, frame.gray, CV_BGR2GRAY);
+                }
+                if( blurFrames ) {
+                    cv::Mat blurred;
+                    cv::GaussianBlur(frame.gray, blurred, blurSize, blurSigma, blurSigma);
+                    frame.gray = blurred;
+                }
+                if( !queue.push(i, frame) ) {
+                    return;
+                }
+            }
+        }));
+    }
+
+    Frame frame;
+    queue.pop(frame);
+    cv::Mat image;
+    if( blurFrames ) {
+        image = frame.gray;
+    } else {
+        cv::GaussianBlur(frame.gray, image, blurSize, blurSigma, blurSigma);
+    }
+    tracker->calculateTransformedImage(image, templateSize);
+    tracker->setTemplateImage( tracker->getTransformedImage() );
+    if( cachePath.empty() ) {
+        tracker->initialize();
+    } else {
+        double startTime = instant::Utils::Others::GetMilliSeconds();
+        bool cached = tracker->initialize(cachePath);
+        std::cout << instant::Utils::String::Format("template %s %s in %.3fsec", cached ? "loaded from" : "saved to",
+                cachePath.c_str(), (instant::Utils::Others::GetMilliSeconds() - startTime)/1000.0) << std::endl;
+    }
+
+    // active computing
+    std::ostringstream rows;
+    cv::Mat blurred;
+    double beginTime = instant::Utils::Others::GetMilliSeconds();
+    for(int f=0; f<(int)filelist.size(); f++) {
+        const std::string& filename = filelist[f];
+        if( f > 0 && !queue.pop(frame) ) {
+            break;
+        }
+        cv::Mat image = frame.gray;
+
+        double startTime = instant::Utils::Others::GetMilliSeconds();
+        if( !blurFrames ) {
+            tracker->blurRegion(image, blurred, blurSize, blurSigma);
+            image = blurred;
+        }
+        tracker->track(image);
+        double endTime = instant::Utils::Others::GetMilliSeconds();
+        result.frames++;
+        result.iterations += tracker->getIterations();
+        result.savedIterations += tracker->getSavedIterations();
+        result.trackingTime += endTime - startTime;
+
+        if( writeRows ) {
+            cv::Matx33d pose = tracker->getModel()->getMatx();
+            rows << dataPath << "," << f << "," << filename;
+            rows << instant::Utils::String::Format(",%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g",
+                    pose(0, 0), pose(0, 1), pose(0, 2), pose(1, 0), pose(1, 1), pose(1, 2), pose(2, 0), pose(2, 1), pose(2, 2));
+            rows << instant::Utils::String::Format(",%d,%.6g,%s,%.3f", tracker->getIterations(), tracker->getSumOfComposeDelta(),
+                    tracker->getStatusName().c_str(), endTime - startTime) << "\n";
+        }
+        if( options.headless ) {
+            continue;
+        }
+
+        // draw result
+        cv::Mat color = frame.color;
+        if( options.verbose ) {
+            std::vector<cv::Mat> pose = tracker->getPoseTrace();
+            Stick::Homography h;
+            for(cv::Mat& p : pose) {
+                h.set(p);
+                h.draw(color, templateSize, CV_RGB(255, 0, 0), 1);
+            }
+
+            cv::imshow("template", tracker->getTemplateImage());
+            cv::imshow("transformed", tracker->getTransformedImage());
+            cv::imshow("error", tracker->getErrorImage()/(255.0/2.0) + 0.5);
+        }
+        tracker->getModel()->draw(color, templateSize, CV_RGB(0, 255, 0), 3);
+        cv::imshow("image", color);
+
+        int waitTime = 30 - (int)(startTime - endTime);
+        waitTime = waitTime <= 0 ? 1 : waitTime;
+        waitTime = options.breakIter ? 0 : waitTime;
+        char ch = cv::waitKey(waitTime);
+        if( ch == 'q' || ch == 'Q' )
+            break;
+
+        if(options.verbose) {
+            std::string message =
+                instant::Utils::String::Format("%s: time=%.3fsec",
+                        filename.c_str(),
+                        (endTime-startTime)/1000.0);
+            std::cout << message << std::endl;
+            std::cout << tracker->getLogString() << std::endl;
+        }
+    }
+    result.totalTime = instant::Utils::Others::GetMilliSeconds() - beginTime;
+    result.rows = rows.str();
+    queue.close();
+    for(std::thread& decoder : decoders) {
+        decoder.join();
+    }
+    delete tracker;
+    return result;
+}
+
 int main(int argc, char* argv[]) {
     static struct option longOptions[] = {
         {"help",      no_argument,       0, 'h'},
@@ -34,41 +337,98 @@ int main(int argc, char* argv[]) {
         {"gaussian",  required_argument, 0, 'g'},
         {"epsilon",   required_argument, 0, 'e'},
         {"iteration", required_argument, 0, 'k'},
+        {"level",     required_argument, 0, 'l'},
+        {"threads",   required_argument, 0, 'j'},
+        {"model",     required_argument, 0, 'm'},
+        {"fraction",  required_argument, 0, 'f'},
+        {"predictor", required_argument, 0, 'P'},
+        {"saved",     no_argument,       0, 'S'},
+        {"algorithm", required_argument, 0, 'a'},
+        {"budget",    required_argument, 0, 'B'},
+        {"adaptive",  no_argument,       0, 'A'},
+        {"cache",     required_argument, 0, 'C'},
+        {"region",    required_argument, 0, 'R'},
+        {"decoders",  required_argument, 0, 'D'},
+        {"queue",     required_argument, 0, 'Q'},
+        {"headless",  no_argument,       0, 'H'},
+        {"output",    required_argument, 0, 'o'},
+        {"workers",   required_argument, 0, 'w'},
         {"break;",    no_argument,       0, 'b'},
         {"verboase",  no_argument,       0, 'v'},
     };
 
-    std::string dataPath;
-    int templateSize = 200;
-    float epsilon = 0.05;
-    int iteration = 100;
-    int gaussianBlurSize = 21;
-    bool breakIter = false;
-    bool verbose = false;
-
+    Options options;
     int argopt, optionIndex=0;
-    while( (argopt = getopt_long(argc, argv, "hp:t:g:e:k:bv", longOptions, &optionIndex)) != -1 ) {
+    while( (argopt = getopt_long(argc, argv, "hp:t:g:e:k:l:j:m:f:P:Sa:B:AC:R:D:Q:Ho:w:bv", longOptions, &optionIndex)) != -1 ) {
         switch( argopt ) {
             case 'p':
-                dataPath = std::string(optarg);
+                options.dataPaths.push_back(std::string(optarg));
                 break;
             case 't':
-                instant::Utils::String::ToPrimitive<int>(optarg, templateSize);
+                instant::Utils::String::ToPrimitive<int>(optarg, options.templateSize);
                 break;
             case 'e':
-                instant::Utils::String::ToPrimitive<float>(optarg, epsilon);
+                instant::Utils::String::ToPrimitive<float>(optarg, options.epsilon);
                 break;
             case 'g':
-                instant::Utils::String::ToPrimitive<int>(optarg, gaussianBlurSize);
+                instant::Utils::String::ToPrimitive<int>(optarg, options.gaussianBlurSize);
                 break;
             case 'k':
-                instant::Utils::String::ToPrimitive<int>(optarg, iteration);
+                instant::Utils::String::ToPrimitive<int>(optarg, options.iteration);
+                break;
+            case 'l':
+                instant::Utils::String::ToPrimitive<int>(optarg, options.pyramidLevel);
+                break;
+            case 'j':
+                instant::Utils::String::ToPrimitive<int>(optarg, options.threads);
+                break;
+            case 'm':
+                options.modelName = std::string(optarg);
+                break;
+            case 'f':
+                instant::Utils::String::ToPrimitive<double>(optarg, options.pixelFraction);
+                break;
+            case 'P':
+                options.predictorName = std::string(optarg);
+                break;
+            case 'S':
+                options.measurePrediction = true;
+                break;
+            case 'a':
+                options.algorithm = std::string(optarg);
+                break;
+            case 'B':
+                instant::Utils::String::ToPrimitive<double>(optarg, options.timeBudget);
+                break;
+            case 'A':
+                options.adaptive = true;
+                break;
+            case 'C':
+                options.cachePath = std::string(optarg);
+                break;
+            case 'R':
+                instant::Utils::String::ToPrimitive<int>(optarg, options.regionMargin);
+                break;
+            case 'D':
+                instant::Utils::String::ToPrimitive<int>(optarg, options.decoderCount);
+                break;
+            case 'Q':
+                instant::Utils::String::ToPrimitive<int>(optarg, options.queueSize);
+                break;
+            case 'H':
+                options.headless = true;
+                break;
+            case 'o':
+                options.outputPath = std::string(optarg);
+                break;
+            case 'w':
+                instant::Utils::String::ToPrimitive<int>(optarg, options.workers);
                 break;
             case 'b':
-                breakIter = true;
+                options.breakIter = true;
                 break;
             case 'v':
-                verbose = true;
+                options.verbose = true;
                 break;
             case 'h':
             default:
@@ -76,62 +436,65 @@ int main(int argc, char* argv[]) {
                 break;
         }
     }
-    if( dataPath.size() == 0 ) {
+    // windows show one sequence at a time
+    if( options.dataPaths.empty() || (options.dataPaths.size() > 1 && !options.headless) ) {
         help(argv[0]);
     }
+    Stick::InverseCompositional* check = createTracker(options);
+    if( check == NULL ) {
+        help(argv[0]);
+    }
+    std::string trackerName = check->getName();
+    delete check;
 
-    std::vector<std::string> filelist;
-    instant::Utils::Filesystem::GetFileNames(dataPath, filelist);
-
-    // initialze
-    Stick::InverseCompositional* tracker = new Stick::InverseCompositional(new Stick::Homography(), epsilon, iteration);
-    cv::Mat image = cv::imread(filelist[0], CV_LOAD_IMAGE_GRAYSCALE);
-    cv::GaussianBlur(image, image, cv::Size(gaussianBlurSize, gaussianBlurSize), gaussianBlurSize/2.0, gaussianBlurSize/2.0);
-    tracker->calculateTransformedImage(image, cv::Size(templateSize, templateSize));
-    tracker->setTemplateImage( tracker->getTransformedImage() );
-    tracker->initialize();
-
-    // active computing
-    for(std::string& filename : filelist){
-        cv::Mat image = cv::imread(filename, CV_LOAD_IMAGE_GRAYSCALE);
-
-        double startTime = instant::Utils::Others::GetMilliSeconds();
-        cv::GaussianBlur(image, image, cv::Size(gaussianBlurSize, gaussianBlurSize), gaussianBlurSize/2.0, gaussianBlurSize/2.0);
-        tracker->track(image);
-        double endTime = instant::Utils::Others::GetMilliSeconds();
-
-        // draw result
-        cv::Mat color = cv::imread(filename, CV_LOAD_IMAGE_COLOR);
-        if( verbose ) {
-            std::vector<cv::Mat> pose = tracker->getPoseTrace();
-            Stick::Homography h;
-            for(cv::Mat& p : pose) {
-                h.set(p);
-                h.draw(color, cv::Size(templateSize, templateSize), CV_RGB(255, 0, 0), 1);
-            }
-            
-            cv::imshow("template", tracker->getTemplateImage());
-            cv::imshow("transformed", tracker->getTransformedImage());
-            cv::imshow("error", tracker->getErrorImage()/(255.0/2.0) + 0.5);
+    std::ofstream output;
+    if( !options.outputPath.empty() ) {
+        output.open(options.outputPath.c_str());
+        if( !output ) {
+            std::cerr << "cannot write " << options.outputPath << std::endl;
+            return -1;
         }
-        tracker->getModel()->draw(color, cv::Size(templateSize, templateSize), CV_RGB(0, 255, 0), 3); 
-        cv::imshow("image", color);
+        output << "sequence,frame,file,h00,h01,h02,h10,h11,h12,h20,h21,h22,iterations,delta,status,time_ms" << std::endl;
+    }
 
-        int waitTime = 30 - (int)(startTime - endTime);
-        waitTime = waitTime <= 0 ? 1 : waitTime;
-        waitTime = breakIter ? 0 : waitTime;
-        char ch = cv::waitKey(waitTime);
-        if( ch == 'q' || ch == 'Q' )
-            break;
+    // one tracker per sequence, the sequences spread over the workers
+    int sequences = (int)options.dataPaths.size();
+    std::vector<Result> results(sequences);
+    double startTime = instant::Utils::Others::GetMilliSeconds();
+    if( sequences == 1 ) {
+        // the windows stay on the main thread
+        results[0] = trackSequence(options, options.dataPaths[0], options.cachePath, output.is_open());
+    } else {
+        Stick::ThreadPool pool(options.workers);
+        pool.run(sequences, [&](int s) {
+            std::string cachePath = options.cachePath;
+            if( !cachePath.empty() ) {
+                cachePath += instant::Utils::String::Format(".%d", s);
+            }
+            results[s] = trackSequence(options, options.dataPaths[s], cachePath, output.is_open());
+        });
+    }
+    double totalTime = instant::Utils::Others::GetMilliSeconds() - startTime;
 
-        if(verbose) {
-            std::string message =
-                instant::Utils::String::Format("%s: time=%.3fsec",
-                        filename.c_str(),
-                        (endTime-startTime)/1000.0);
-            std::cout << message << std::endl;
-            std::cout << tracker->getLogString() << std::endl;
+    int frames = 0;
+    for(const Result& result : results) {
+        if( output.is_open() ) {
+            output << result.rows;
+        }
+        frames += result.frames;
+        std::cout << instant::Utils::String::Format("%s %s frames:%d, iterations per frame:%.2f, time per frame:%.3fsec, fps:%.1f, predictor:%s",
+                trackerName.c_str(), result.name.c_str(), result.frames, result.frames ? (double)result.iterations/result.frames : 0.0,
+                result.frames ? result.trackingTime/result.frames/1000.0 : 0.0,
+                result.totalTime > 0.0 ? result.frames*1000.0/result.totalTime : 0.0, options.predictorName.c_str());
+        if( options.measurePrediction && options.predictorName != "none" ) {
+            std::cout << instant::Utils::String::Format(", saved iterations per frame:%.2f",
+                    result.frames ? (double)result.savedIterations/result.frames : 0.0);
         }
+        std::cout << std::endl;
+    }
+    if( sequences > 1 ) {
+        std::cout << instant::Utils::String::Format("sequences:%d, frames:%d, time:%.3fsec, fps:%.1f",
+                sequences, frames, totalTime/1000.0, totalTime > 0.0 ? frames*1000.0/totalTime : 0.0) << std::endl;
     }
 
     return 0;
@@ -3,43 +3,132 @@
 #include <getopt.h>
 #include <string>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
 
 #include <utils/string.hpp>
 #include <utils/filesystem.hpp>
 #include <utils/others.hpp>
 #include <opencv2/opencv.hpp>
 
+#include <tracker/inverse_compositional.hpp>
+#include <parallel/latest_slot.hpp>
+#include <io/packed_sequence.hpp>
+#include <model/homography.hpp>
+
 void help(char* execute) {
-    std::cerr << "usage: " << execute << " [-h] -p DATA_PATH [-t TEMPLATE_SIZE] [-g GAUSSIAN_KERNAL_SIZE] [-e EPSILON_VALUE] [-k ITERATION] [-v]" << std::endl;
+    std::cerr << "usage: " << execute << " [-h] [-c CAMERA | -i INPUT] [-r RATE] [-t TEMPLATE_SIZE] [-g GAUSSIAN_KERNAL_SIZE] [-e EPSILON_VALUE] [-k ITERATION] [-l PYRAMID_LEVEL] [-R MARGIN] [-H] [-v]" << std::endl;
     std::cerr << "" << std::endl;
     std::cerr << "\t-h, --help                           show this help message and exit" << std::endl;
+    std::cerr << "\t-c, --camera    CAMERA               capture from device CAMERA (default:0)" << std::endl;
+    std::cerr << "\t-i, --input     INPUT                replay the video file or packed sequence INPUT in place of a camera" << std::endl;
+    std::cerr << "\t-r, --rate      RATE                 deliver INPUT frames at RATE per second like a camera, 0 for as fast as read (default:recorded rate or 30)" << std::endl;
     std::cerr << "\t-t, --template  SIZE                 set TEMPLATE_SIZE (default:300)" << std::endl;
     std::cerr << "\t-g, --gaussian  GAUSSIAN_KERNAL_SIZE set GAUSSIAN_KERNAL_SIZE (default:49)" << std::endl;
     std::cerr << "\t-e, --epsilon   EPSILON_VALUE        set EPSILON_VALUE (default:0.05)" << std::endl;
     std::cerr << "\t-k, --iteration ITERATION            set max ITERATION per update (default:100)" << std::endl;
+    std::cerr << "\t-l, --level     PYRAMID_LEVEL        set coarse-to-fine PYRAMID_LEVEL (default:1)" << std::endl;
+    std::cerr << "\t-R, --region    MARGIN               blur and track only the predicted template region grown by MARGIN pixels, 0 for the whole frame (default:32)" << std::endl;
+    std::cerr << "\t-H, --headless                       no windows, the first frame becomes the template" << std::endl;
     std::cerr << "\t-v, --verbose                        verbose" << std::endl;
+    std::cerr << "" << std::endl;
+    std::cerr << "\tkeys: space picks the center of the frame as the template, r resets the pose, q quits" << std::endl;
     exit(-1);
 }
 
+// camera, video file or packed sequence, read one frame at a time
+class FrameSource {
+    public:
+        FrameSource() : next(0) {
+        }
+
+        bool open(int camera) {
+            return this->capture.open(camera);
+        }
+        bool open(const std::string& path) {
+            if( Stick::PackedSequence::IsPackedSequence(path) ) {
+                this->packed.reset(new Stick::PackedSequence(path));
+                return true;
+            }
+            return this->capture.open(path);
+        }
+        // a new buffer every frame, the previous one may still be in use by the tracker.
+        // packed frames are read only views on the mapping
+        bool read(cv::Mat& image) {
+            if( this->packed ) {
+                if( this->next >= this->packed->getFrameCount() ) {
+                    return false;
+                }
+                image = this->packed->getFrame(this->next++);
+                return true;
+            }
+            return this->capture.read(image) && !image.empty();
+        }
+        // frames per second the input was recorded at, 0 when unknown
+        double getRate() {
+            return this->packed ? this->packed->getRate() : this->capture.get(CV_CAP_PROP_FPS);
+        }
+
+    protected:
+        cv::VideoCapture capture;
+        std::unique_ptr<Stick::PackedSequence> packed;
+        size_t next;
+};
+
+struct Frame {
+    Frame() : index(0), captured(0.0) {
+    }
+
+    cv::Mat image;
+    long index;
+    // when the capture thread got it, the start of the glass-to-pose latency
+    double captured;
+};
+
 int main(int argc, char* argv[]) {
     static struct option longOptions[] = {
         {"help",      no_argument,       0, 'h'},
+        {"camera",    required_argument, 0, 'c'},
+        {"input",     required_argument, 0, 'i'},
+        {"rate",      required_argument, 0, 'r'},
         {"template",  required_argument, 0, 't'},
         {"gaussian",  required_argument, 0, 'g'},
         {"epsilon",   required_argument, 0, 'e'},
         {"iteration", required_argument, 0, 'k'},
-        {"verboase",  no_argument,       0, 'v'},
+        {"level",     required_argument, 0, 'l'},
+        {"region",    required_argument, 0, 'R'},
+        {"headless",  no_argument,       0, 'H'},
+        {"verbose",   no_argument,       0, 'v'},
+        {0, 0, 0, 0}
     };
 
+    int camera = 0;
+    std::string inputPath;
+    double rate = -1.0;
     int templateSize = 300;
     float epsilon = 0.05;
     int iteration = 100;
     int gaussianBlurSize = 49;
+    int pyramidLevel = 1;
+    int regionMargin = 32;
+    bool headless = false;
     bool verbose = 0;
 
     int argopt, optionIndex=0;
-    while( (argopt = getopt_long(argc, argv, "ht:g:e:k:v", longOptions, &optionIndex)) != -1 ) {
+    while( (argopt = getopt_long(argc, argv, "hc:i:r:t:g:e:k:l:R:Hv", longOptions, &optionIndex)) != -1 ) {
         switch( argopt ) {
+            case 'c':
+                instant::Utils::String::ToPrimitive<int>(optarg, camera);
+                break;
+            case 'i':
+                inputPath = std::string(optarg);
+                break;
+            case 'r':
+                instant::Utils::String::ToPrimitive<double>(optarg, rate);
+                break;
             case 't':
                 instant::Utils::String::ToPrimitive<int>(optarg, templateSize);
                 break;
@@ -52,6 +141,15 @@ int main(int argc, char* argv[]) {
             case 'k':
                 instant::Utils::String::ToPrimitive<int>(optarg, iteration);
                 break;
+            case 'l':
+                instant::Utils::String::ToPrimitive<int>(optarg, pyramidLevel);
+                break;
+            case 'R':
+                instant::Utils::String::ToPrimitive<int>(optarg, regionMargin);
+                break;
+            case 'H':
+                headless = true;
+                break;
             case 'v':
                 verbose = true;
                 break;
@@ -62,49 +160,132 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    cv::VideoCapture capture(0);
+    FrameSource source;
+    bool opened = inputPath.empty() ? source.open(camera) : source.open(inputPath);
+    if( !opened ) {
+        std::cerr << "cannot open " << (inputPath.empty() ? instant::Utils::String::Format("camera %d", camera) : inputPath) << std::endl;
+        return -1;
+    }
+    // a camera delivers at its own rate, a file is paced to look like one
+    if( inputPath.empty() ) {
+        rate = 0.0;
+    } else if( rate < 0.0 ) {
+        rate = source.getRate() > 0.0 ? source.getRate() : 30.0;
+    }
 
-    bool processing = true, tracking = false;
-    while(processing) {
-        cv::Mat image;
-        capture >> image;
+    Stick::InverseCompositional tracker(new Stick::Homography(), epsilon, iteration, pyramidLevel);
+    tracker.setRegionMargin( regionMargin );
+    cv::Size size(templateSize, templateSize);
+    cv::Size blurSize(gaussianBlurSize, gaussianBlurSize);
+    double blurSigma = gaussianBlurSize/2.0;
 
+    // the capture thread never waits for tracking, a frame not taken before the next one arrives is dropped
+    Stick::LatestSlot<Frame> slot;
+    std::atomic<bool> capturing(true);
+    std::atomic<long> captured(0);
+    std::thread capture([&]() {
         double startTime = instant::Utils::Others::GetMilliSeconds();
-        if(tracking) {
-            cv::Mat gray;
-            cv::cvtColor(image, gray, CV_BGR2GRAY);
+        while( capturing ) {
+            Frame frame;
+            if( !source.read(frame.image) ) {
+                break;
+            }
+            frame.captured = instant::Utils::Others::GetMilliSeconds();
+            frame.index = captured++;
+            slot.put(frame);
+
+            if( rate > 0.0 ) {
+                double wait = startTime + captured*1000.0/rate - instant::Utils::Others::GetMilliSeconds();
+                if( wait > 0.0 ) {
+                    std::this_thread::sleep_for(std::chrono::microseconds((long)(wait*1000.0)));
+                }
+            }
         }
-        double endTime = instant::Utils::Others::GetMilliSeconds();
+        slot.close();
+    });
 
-        // draw result
-        if( verbose ) {
+    int tracked = 0;
+    double latencySum = 0.0, latencyMax = 0.0;
+    double beginTime = instant::Utils::Others::GetMilliSeconds();
+    bool tracking = false, picking = headless;
+    cv::Mat blurred;
+    Frame frame;
+    while( slot.take(frame) ) {
+        cv::Mat gray, color;
+        if( frame.image.channels() == 1 ) {
+            gray = frame.image;
+        } else {
+            color = frame.image;
+            cv::cvtColor(color, gray, CV_BGR2GRAY);
         }
-        
-        cv::imshow("image", image);
-        char ch = cv::waitKey(1);
-        switch( ch ) {
-            case 'q':
-            case 'Q':
-                processing = false;
-                break;
-            case 'r':
-            case 'R':
-                {
-                }
-                break;
-            case ' ':
-                {
-                }
-                break;
+
+        if( picking ) {
+            // the center of the frame becomes the template, built in the background while frames keep coming
+            // and tracked from the identity once switched in
+            cv::Mat image;
+            cv::GaussianBlur(gray, image, blurSize, blurSigma, blurSigma);
+            tracking = false;
+            tracker.getModel()->initialize();
+            tracker.calculateTransformedImage(image, size);
+            tracker.initializeAsync( tracker.getTransformedImage() );
+            picking = false;
+        }
+
+        double startTime = instant::Utils::Others::GetMilliSeconds();
+        if( !tracking && tracker.updateTemplate() ) {
+            tracking = true;
+        }
+        double latency = 0.0;
+        if( tracking ) {
+            tracker.blurRegion(gray, blurred, blurSize, blurSigma);
+            tracker.track(blurred);
+
+            latency = instant::Utils::Others::GetMilliSeconds() - frame.captured;
+            latencySum += latency;
+            latencyMax = std::max(latencyMax, latency);
+            tracked++;
         }
-        
+        double endTime = instant::Utils::Others::GetMilliSeconds();
+
         if(verbose) {
             std::string message =
-                instant::Utils::String::Format("time=%.3fsec",
-                        (endTime-startTime)/1000.0);
+                instant::Utils::String::Format("frame:%ld, time=%.3fsec, latency=%.1fms",
+                        frame.index, (endTime-startTime)/1000.0, latency);
             std::cout << message << std::endl;
+            if( tracking ) {
+                std::cout << tracker.getLogString() << std::endl;
+            }
+        }
+        if( headless ) {
+            continue;
+        }
+
+        // draw result
+        if( color.empty() ) {
+            cv::cvtColor(frame.image, color, CV_GRAY2BGR);
+        }
+        if( tracking ) {
+            tracker.getModel()->draw(color, size, CV_RGB(0, 255, 0), 3);
+            cv::putText(color, instant::Utils::String::Format("latency %.1fms", latency), cv::Point(10, 30),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.8, CV_RGB(0, 255, 0), 2);
+        }
+        cv::imshow("image", color);
+        char ch = cv::waitKey(1);
+        if( ch == 'q' || ch == 'Q' ) {
+            break;
+        } else if( ch == 'r' || ch == 'R' ) {
+            tracker.getModel()->initialize();
+        } else if( ch == ' ' ) {
+            picking = true;
         }
     }
+    double totalTime = instant::Utils::Others::GetMilliSeconds() - beginTime;
+    capturing = false;
+    capture.join();
+
+    std::cout << instant::Utils::String::Format("captured:%ld, tracked:%d, dropped:%ld, latency mean:%.1fms max:%.1fms, fps:%.1f",
+            (long)captured, tracked, slot.getDropped(), tracked ? latencySum/tracked : 0.0, latencyMax,
+            totalTime > 0.0 ? tracked*1000.0/totalTime : 0.0) << std::endl;
 
     return 0;
 }
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <utils/string.hpp>
+#include <utils/filesystem.hpp>
+#include <utils/others.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <io/packed_sequence.hpp>
+
+void help(char* execute) {
+    std::cerr << "usage: " << execute << " [-h] (-p DATA_PATH | -i INPUT) -o OUTPUT [-r RATE] [-v]" << std::endl;
+    std::cerr << "" << std::endl;
+    std::cerr << "\t-h, --help                           show this help message and exit" << std::endl;
+    std::cerr << "\t-p, --path      DATA_PATH            pack the images in DATA_PATH, in file name order" << std::endl;
+    std::cerr << "\t-i, --input     INPUT                pack the frames of the video file INPUT" << std::endl;
+    std::cerr << "\t-o, --output    OUTPUT               write the packed gray sequence to OUTPUT" << std::endl;
+    std::cerr << "\t-r, --rate      RATE                 record RATE frames per second (default:video rate, unknown for images)" << std::endl;
+    std::cerr << "\t-v, --verbose                        verbose" << std::endl;
+    exit(-1);
+}
+
+int main(int argc, char* argv[]) {
+    static struct option longOptions[] = {
+        {"help",      no_argument,       0, 'h'},
+        {"path",      required_argument, 0, 'p'},
+        {"input",     required_argument, 0, 'i'},
+        {"output",    required_argument, 0, 'o'},
+        {"rate",      required_argument, 0, 'r'},
+        {"verbose",   no_argument,       0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    std::string dataPath;
+    std::string inputPath;
+    std::string outputPath;
+    double rate = -1.0;
+    bool verbose = false;
+
+    int argopt, optionIndex=0;
+    while( (argopt = getopt_long(argc, argv, "hp:i:o:r:v", longOptions, &optionIndex)) != -1 ) {
+        switch( argopt ) {
+            case 'p':
+                dataPath = std::string(optarg);
+                break;
+            case 'i':
+                inputPath = std::string(optarg);
+                break;
+            case 'o':
+                outputPath = std::string(optarg);
+                break;
+            case 'r':
+                instant::Utils::String::ToPrimitive<double>(optarg, rate);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'h':
+            default:
+                help(argv[0]);
+                break;
+        }
+    }
+    if( dataPath.empty() == inputPath.empty() || outputPath.empty() ) {
+        help(argv[0]);
+    }
+
+    cv::VideoCapture capture;
+    std::vector<std::string> filelist;
+    if( inputPath.empty() ) {
+        instant::Utils::Filesystem::GetFileNames(dataPath, filelist);
+        if( filelist.empty() ) {
+            std::cerr << "no frames in " << dataPath << std::endl;
+            return -1;
+        }
+    } else if( !capture.open(inputPath) ) {
+        std::cerr << "cannot open " << inputPath << std::endl;
+        return -1;
+    }
+    if( rate < 0.0 ) {
+        rate = inputPath.empty() ? 0.0 : std::max(0.0, capture.get(CV_CAP_PROP_FPS));
+    }
+
+    double startTime = instant::Utils::Others::GetMilliSeconds();
+    Stick::PackedSequenceWriter writer(outputPath, rate);
+    size_t pixels = 0;
+    for(int f=0; ; f++) {
+        cv::Mat color, gray;
+        std::string name;
+        if( inputPath.empty() ) {
+            if( f >= (int)filelist.size() ) {
+                break;
+            }
+            name = filelist[f];
+            // decoded as the tracking apps do, color first and then converted
+            color = cv::imread(name, CV_LOAD_IMAGE_COLOR);
+            if( color.empty() ) {
+                std::cerr << "cannot read " << name << std::endl;
+                return -1;
+            }
+        } else {
+            if( !capture.read(color) || color.empty() ) {
+                break;
+            }
+            name = instant::Utils::String::Format("%s:%d", inputPath.c_str(), f);
+        }
+        if( color.channels() == 1 ) {
+            gray = color;
+        } else {
+            cv::cvtColor(color, gray, CV_BGR2GRAY);
+        }
+        writer.append(gray, name);
+        pixels += gray.total();
+
+        if( verbose ) {
+            std::cout << instant::Utils::String::Format("%s: %dx%d", name.c_str(), gray.cols, gray.rows) << std::endl;
+        }
+    }
+    writer.close();
+    double totalTime = instant::Utils::Others::GetMilliSeconds() - startTime;
+
+    std::cout << instant::Utils::String::Format("%s frames:%d, pixels:%lu, rate:%.2f, time:%.3fsec",
+            outputPath.c_str(), (int)writer.getFrameCount(), (unsigned long)pixels, rate, totalTime/1000.0) << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "io/binary_file.hpp"
+
+#include "exceptions/invalid_parameters.hpp"
+
+#include <thread>
+#include <functional>
+#include <unistd.h>
+
+using namespace Stick;
+
+const size_t BinaryWriter::Alignment;
+
+BinaryReader::BinaryReader(const char* data, size_t size, size_t offset, const std::string& owner, const std::string& description)
+    : data(data), size(size), offset(offset), owner(owner), description(description) {
+}
+
+const char* BinaryReader::take(size_t size) {
+    if( this->offset > this->size || size > this->size - this->offset ) {
+        throw MakeException(InvalidParameters, this->owner, "truncated " + this->description);
+    }
+    const char* data = this->data + this->offset;
+    this->offset += size;
+    return data;
+}
+
+void BinaryReader::align() {
+    this->take((BinaryWriter::Alignment - this->offset % BinaryWriter::Alignment) % BinaryWriter::Alignment);
+}
+
+BinaryWriter::BinaryWriter(const std::string& path, const std::string& owner, const std::string& description)
+    : path(path), owner(owner), description(description), offset(0) {
+    // unique per process and thread, concurrent writers of one path never share a temporary file
+    unsigned long thread = (unsigned long)std::hash<std::thread::id>()(std::this_thread::get_id());
+    this->temporary = path + instant::Utils::String::Format(".%d.%lx.tmp", (int)getpid(), thread);
+    this->file = fopen(this->temporary.c_str(), "wb");
+    if( this->file == NULL ) {
+        throw MakeException(InvalidParameters, this->owner, instant::Utils::String::Format("cannot write %s (path:%s)", this->description.c_str(), this->temporary.c_str()));
+    }
+}
+
+BinaryWriter::~BinaryWriter() {
+    if( this->file != NULL ) {
+        fclose(this->file);
+        remove(this->temporary.c_str());
+    }
+}
+
+void BinaryWriter::checkOpen() {
+    if( this->file == NULL ) {
+        throw MakeException(InvalidParameters, this->owner, instant::Utils::String::Format("%s already closed (path:%s)", this->description.c_str(), this->path.c_str()));
+    }
+}
+
+void BinaryWriter::check(bool written) {
+    if( !written ) {
+        throw MakeException(InvalidParameters, this->owner, instant::Utils::String::Format("cannot write %s (path:%s)", this->description.c_str(), this->temporary.c_str()));
+    }
+}
+
+void BinaryWriter::append(const void* data, size_t size) {
+    this->checkOpen();
+    this->check(size == 0 || fwrite(data, 1, size, this->file) == size);
+    this->offset += size;
+}
+
+void BinaryWriter::align() {
+    static const char zeros[Alignment] = {0};
+    this->append(zeros, (Alignment - this->offset % Alignment) % Alignment);
+}
+
+void BinaryWriter::patch(size_t offset, const void* data, size_t size) {
+    this->checkOpen();
+    this->check(offset + size <= this->offset && fseek(this->file, offset, SEEK_SET) == 0 &&
+                fwrite(data, 1, size, this->file) == size && fseek(this->file, 0, SEEK_END) == 0);
+}
+
+void BinaryWriter::commit() {
+    this->checkOpen();
+    bool failed = fclose(this->file) != 0;
+    this->file = NULL;
+    if( failed || rename(this->temporary.c_str(), this->path.c_str()) != 0 ) {
+        remove(this->temporary.c_str());
+        throw MakeException(InvalidParameters, this->owner, instant::Utils::String::Format("cannot write %s (path:%s)", this->description.c_str(), this->path.c_str()));
+    }
+}
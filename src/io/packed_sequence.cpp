@@ -0,0 +1,146 @@
+#include "io/packed_sequence.hpp"
+
+#include "exceptions/invalid_parameters.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace Stick;
+
+const uint32_t PackedSequence::Version;
+
+static const char Magic[8] = {'S', 'T', 'I', 'C', 'K', 'S', 'E', 'Q'};
+static const uint32_t ByteOrder = 0x01020304;
+// magic, version, byte order, frame count, index offset, rate
+static const size_t HeaderSize = sizeof(Magic) + 2*sizeof(uint32_t) + 2*sizeof(uint64_t) + sizeof(double);
+static const size_t FrameCountOffset = sizeof(Magic) + 2*sizeof(uint32_t);
+
+PackedSequence::PackedSequence(const std::string& path) {
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if( descriptor < 0 ) {
+        throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("cannot open packed sequence (path:%s)", path.c_str()));
+    }
+    struct stat status;
+    if( fstat(descriptor, &status) != 0 || (size_t)status.st_size < HeaderSize ) {
+        close(descriptor);
+        throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("not a packed sequence (path:%s)", path.c_str()));
+    }
+    this->length = status.st_size;
+    this->address = mmap(NULL, this->length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if( this->address == MAP_FAILED ) {
+        throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("cannot map packed sequence (path:%s)", path.c_str()));
+    }
+    // replay reads the frames front to back, the kernel can read ahead aggressively
+    madvise(this->address, this->length, MADV_SEQUENTIAL);
+
+    try {
+        BinaryReader reader((const char*)this->address, this->length, 0, "PackedSequence", "packed sequence");
+        if( memcmp(reader.take(sizeof(Magic)), Magic, sizeof(Magic)) != 0 ) {
+            throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("not a packed sequence (path:%s)", path.c_str()));
+        }
+        if( reader.get<uint32_t>() != Version || reader.get<uint32_t>() != ByteOrder ) {
+            throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("packed sequence of another version or byte order (path:%s)", path.c_str()));
+        }
+        uint64_t frameCount = reader.get<uint64_t>();
+        uint64_t indexOffset = reader.get<uint64_t>();
+        this->rate = reader.get<double>();
+
+        BinaryReader index((const char*)this->address, this->length, indexOffset, "PackedSequence", "packed sequence");
+        for(uint64_t f=0; f<frameCount; f++) {
+            PackedFrame frame;
+            frame.offset = index.get<uint64_t>();
+            frame.rows = index.get<int32_t>();
+            frame.cols = index.get<int32_t>();
+            uint32_t nameLength = index.get<uint32_t>();
+            frame.name.assign(index.take(nameLength), nameLength);
+            // the pixels have to lie inside the mapping too
+            if( frame.rows <= 0 || frame.cols <= 0 ) {
+                throw MakeException(InvalidParameters, "PackedSequence", "malformed frame in packed sequence");
+            }
+            BinaryReader((const char*)this->address, this->length, frame.offset, "PackedSequence", "packed sequence").take((size_t)frame.rows * frame.cols);
+            this->frames.push_back(frame);
+        }
+    } catch(...) {
+        munmap(this->address, this->length);
+        throw;
+    }
+}
+
+PackedSequence::~PackedSequence() {
+    munmap(this->address, this->length);
+}
+
+bool PackedSequence::IsPackedSequence(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if( file == NULL ) {
+        return false;
+    }
+    char magic[sizeof(Magic)];
+    bool packed = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, Magic, sizeof(Magic)) == 0;
+    fclose(file);
+    return packed;
+}
+
+cv::Mat PackedSequence::getFrame(size_t index) const {
+    if( index >= this->frames.size() ) {
+        throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("frame out of range (index:%d, frames:%d)", (int)index, (int)this->frames.size()));
+    }
+    const PackedFrame& frame = this->frames[index];
+    return cv::Mat(frame.rows, frame.cols, CV_8UC1, (char*)this->address + frame.offset);
+}
+
+const std::string& PackedSequence::getFrameName(size_t index) const {
+    if( index >= this->frames.size() ) {
+        throw MakeException(InvalidParameters, "PackedSequence", instant::Utils::String::Format("frame out of range (index:%d, frames:%d)", (int)index, (int)this->frames.size()));
+    }
+    return this->frames[index].name;
+}
+
+PackedSequenceWriter::PackedSequenceWriter(const std::string& path, double rate) : writer(path, "PackedSequenceWriter", "packed sequence") {
+    // frame count and index offset are filled in by close()
+    this->writer.append(Magic, sizeof(Magic));
+    this->writer.put<uint32_t>(PackedSequence::Version);
+    this->writer.put<uint32_t>(ByteOrder);
+    this->writer.put<uint64_t>(0);
+    this->writer.put<uint64_t>(0);
+    this->writer.put<double>(rate);
+}
+
+PackedSequenceWriter::~PackedSequenceWriter() {
+}
+
+void PackedSequenceWriter::append(const cv::Mat& image, const std::string& name) {
+    if( image.empty() || image.type() != CV_8UC1 ) {
+        throw MakeException(InvalidParameters, "PackedSequenceWriter", instant::Utils::String::Format("frames must be 8 bit gray (name:%s)", name.c_str()));
+    }
+    this->writer.align();
+
+    PackedFrame frame;
+    frame.offset = this->writer.getOffset();
+    frame.rows = image.rows;
+    frame.cols = image.cols;
+    frame.name = name;
+    for(int r=0; r<image.rows; r++) {
+        this->writer.append(image.ptr(r), image.cols);
+    }
+    this->frames.push_back(frame);
+}
+
+void PackedSequenceWriter::close() {
+    uint64_t indexOffset = this->writer.getOffset();
+    for(const PackedFrame& frame : this->frames) {
+        this->writer.put<uint64_t>(frame.offset);
+        this->writer.put<int32_t>(frame.rows);
+        this->writer.put<int32_t>(frame.cols);
+        this->writer.put<uint32_t>(frame.name.size());
+        this->writer.append(frame.name.data(), frame.name.size());
+    }
+    uint64_t counts[2] = {this->frames.size(), indexOffset};
+    this->writer.patch(FrameCountOffset, counts, sizeof(counts));
+    this->writer.commit();
+}
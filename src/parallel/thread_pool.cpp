@@ -0,0 +1,116 @@
+#include "parallel/thread_pool.hpp"
+
+#include <algorithm>
+
+using namespace Stick;
+
+static int resolveThreads(int threads) {
+    if( threads > 0 ) {
+        return threads;
+    }
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(int threads) : ranges(resolveThreads(threads)) {
+    this->task = NULL;
+    this->generation = 0;
+    this->remaining = 0;
+    this->stopping = false;
+    for(Range& range : this->ranges) {
+        range.begin = range.end = 0;
+    }
+    for(int w=0; w<(int)this->ranges.size(); w++) {
+        this->workers.push_back(std::thread(&ThreadPool::work, this, w));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->started.notify_all();
+    for(std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int count, const std::function<void(int)>& task) {
+    if( count <= 0 ) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &task;
+        this->remaining = count;
+        this->exception = std::exception_ptr();
+    }
+
+    int workers = (int)this->ranges.size();
+    for(int w=0; w<workers; w++) {
+        std::lock_guard<std::mutex> lock(this->ranges[w].mutex);
+        this->ranges[w].begin = (int)((long long)count * w / workers);
+        this->ranges[w].end = (int)((long long)count * (w+1) / workers);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->generation++;
+    }
+    this->started.notify_all();
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->finished.wait(lock, [this]() { return this->remaining == 0; });
+        exception = this->exception;
+        this->task = NULL;
+    }
+    if( exception ) {
+        std::rethrow_exception(exception);
+    }
+}
+
+// own range from the front, then the other ranges from the back
+bool ThreadPool::take(int worker, int& index) {
+    int workers = (int)this->ranges.size();
+    for(int v=0; v<workers; v++) {
+        Range& range = this->ranges[(worker + v) % workers];
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if( range.begin < range.end ) {
+            index = v == 0 ? range.begin++ : --range.end;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::work(int worker) {
+    unsigned long seen = 0;
+    while( true ) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->started.wait(lock, [this, seen]() { return this->stopping || this->generation != seen; });
+            if( this->stopping ) {
+                return;
+            }
+            seen = this->generation;
+        }
+
+        int index;
+        while( this->take(worker, index) ) {
+            try {
+                (*this->task)(index);
+            } catch(...) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if( !this->exception ) {
+                    this->exception = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if( --this->remaining == 0 ) {
+                this->finished.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,210 @@
+#include "tracker/esm.hpp"
+
+#include "tracker/kernels.hpp"
+#include "tracker/sampling.hpp"
+
+using namespace Stick;
+
+// solves a * x = b in place for a symmetric positive definite a (n x n, row major), b becomes x.
+// returns false when a is not positive definite
+static bool solveCholesky(double* a, double* b, int n) {
+    for(int j=0; j<n; j++) {
+        double d = a[j*n + j];
+        for(int k=0; k<j; k++) {
+            d -= a[j*n + k] * a[j*n + k];
+        }
+        if( !(d > 0.0) ) {
+            return false;
+        }
+        a[j*n + j] = std::sqrt(d);
+        for(int i=j+1; i<n; i++) {
+            double s = a[i*n + j];
+            for(int k=0; k<j; k++) {
+                s -= a[i*n + k] * a[j*n + k];
+            }
+            a[i*n + j] = s / a[j*n + j];
+        }
+    }
+    for(int i=0; i<n; i++) {
+        for(int k=0; k<i; k++) {
+            b[i] -= a[i*n + k] * b[k];
+        }
+        b[i] /= a[i*n + i];
+    }
+    for(int i=n-1; i>=0; i--) {
+        for(int k=i+1; k<n; k++) {
+            b[i] -= a[k*n + i] * b[k];
+        }
+        b[i] /= a[i*n + i];
+    }
+    return true;
+}
+
+template<typename T>
+void ESMT<T>::buildTemplateData(TemplateData& templateData, const cv::Mat& image) {
+    InverseCompositionalT<T>::buildTemplateData(templateData, image);
+    for(Level& level : templateData.levels) {
+        this->calculateJacobians(level);
+    }
+}
+
+// data built by an InverseCompositional lacks the jacobians, they are added to a shallow copy sharing everything else
+template<typename T>
+void ESMT<T>::setTemplateData(const std::shared_ptr<const TemplateData>& templateData) {
+    if( !templateData || templateData->levels.empty() || !templateData->levels[0].jacobians.empty() ) {
+        InverseCompositionalT<T>::setTemplateData(templateData);
+        return;
+    }
+
+    std::shared_ptr<TemplateData> extended = std::make_shared<TemplateData>(*templateData);
+    for(Level& level : extended->levels) {
+        this->calculateJacobians(level);
+    }
+    InverseCompositionalT<T>::setTemplateData(extended);
+}
+
+template<typename T>
+void ESMT<T>::calculateJacobians(Level& level) {
+    int width = level.templateImage.size().width;
+    int height = level.templateImage.size().height;
+    int params = this->model->getParameterSize();
+    int count = level.getCount();
+    bool selected = !level.pixels.empty();
+
+    cv::Mat& jacobians = level.jacobians;
+    jacobians = cv::Mat::zeros(cv::Size(count, 2*params), cv::DataType<T>::type);
+
+    std::vector<double> row(2*params*width);
+    int next = 0;
+    for(int y=0; y<height && next<count; y++) {
+        this->templateModel->jacobianRow(-(double)width/2.0, (double)y - (double)height/2.0, width, &row[0]);
+        for(int x=0; x<width && next<count; x++) {
+            if( selected && level.pixels[next] != y*width + x ) {
+                continue;
+            }
+            for(int r=0; r<2*params; r++) {
+                jacobians.at<T>(r, next) = (T)row[r*width + x];
+            }
+            next++;
+        }
+    }
+}
+
+template<typename T>
+void ESMT<T>::allocateBuffers() {
+    InverseCompositionalT<T>::allocateBuffers();
+
+    int params = this->model->getParameterSize();
+    cv::Size size = this->templateData->levels[0].templateImage.size();
+
+    this->hessian.assign(params*params, 0.0);
+    this->rowSums.assign(size.height*(params + params*params + 1), 0.0);
+    this->rowBuffers.assign(this->threads, std::vector<T>((4 + params)*size.width));
+}
+
+// one pass over the template rows: warp the pixel and its neighbours, then accumulate
+// J^T * error and J^T * J with J the mean of the template and the warped image steepest descent images
+template<typename T>
+bool ESMT<T>::calculateDelta(int l, const cv::Matx33d& warp, double scale, double* delta) {
+    const Level& level = this->templateData->levels[l];
+    const cv::Mat& image = this->imagePyramid[l];
+    const cv::Mat& jacobians = level.jacobians;
+    int width = level.templateImage.size().width;
+    int height = level.templateImage.size().height;
+    int params = this->model->getParameterSize();
+    int count = level.getCount();
+    int rows = (count + width - 1) / width;
+    int tiles = level.getTilesPerRow();
+    int stride = params + params*params + 1;
+    bool selected = !level.pixels.empty();
+
+    const double* h = warp.val;
+
+    const Kernels::Table& kernels = Kernels::get();
+    double* rowSums = &this->rowSums[0];
+    this->parallelRows([&]() {
+        T* sampled = this->getRowBuffer();
+        T* dx = sampled + width;
+        T* dy = dx + width;
+        T* error = dy + width;
+        T* steepest = error + width;
+        #pragma omp for schedule(static)
+        for(int row=0; row<rows; row++) {
+            int begin = row*width;
+            int length = std::min(width, count - begin);
+            const int* pixels = selected ? &level.pixels[begin] : NULL;
+            for(int i=0; i<length; i++) {
+                int x = i, y = row;
+                if( pixels ) {
+                    x = pixels[i] % width;
+                    y = pixels[i] / width;
+                }
+                sampled[i] = sampleWarped(image, h, x, y);
+
+                // central differences of the warped image, zero on the border like the template gradients
+                dx[i] = dy[i] = 0;
+                if( x > 0 && y > 0 && x < width-1 && y < height-1 ) {
+                    dx[i] = sampleWarped(image, h, x+1, y) - sampleWarped(image, h, x-1, y);
+                    dy[i] = sampleWarped(image, h, x, y+1) - sampleWarped(image, h, x, y-1);
+                }
+            }
+            const unsigned char* reference = selected ? &level.reference[begin] : level.templateImage.ptr<unsigned char>(row);
+            Kernels::errorRow(kernels, sampled, reference, length, scale, error);
+
+            // central differences are twice the gradient on both sides, so their mean is a quarter of the sum and
+            // the update is a whole second-order step
+            const T* templateSteepest = level.steepest.ptr<T>(row*tiles);
+            for(int p=0; p<params; p++) {
+                T* out = steepest + p*width;
+                Kernels::steepestRow(kernels, jacobians.ptr<T>(2*p) + begin, jacobians.ptr<T>(2*p+1) + begin, dx, dy, length, out);
+                for(int i=0; i<length; i++) {
+                    const T* tile = templateSteepest + (i/Kernels::TileSize)*params*Kernels::TileSize;
+                    out[i] = (T)0.25 * (out[i] + tile[p*Kernels::TileSize + i%Kernels::TileSize]);
+                }
+            }
+
+            double* sums = rowSums + row*stride;
+            for(int p=0; p<params; p++) {
+                sums[p] = Kernels::dot(kernels, steepest + p*width, error, length);
+                for(int q=p; q<params; q++) {
+                    sums[params + p*params + q] = Kernels::dot(kernels, steepest + p*width, steepest + q*width, length);
+                }
+            }
+            sums[stride - 1] = Kernels::dot(kernels, error, error, length);
+        }
+    });
+
+    // reduced in row order, independent of the number of threads
+    double* hessian = &this->hessian[0];
+    this->squaredError = 0.0;
+    for(int p=0; p<params; p++) {
+        delta[p] = 0.0;
+        for(int q=p; q<params; q++) {
+            hessian[p*params + q] = 0.0;
+        }
+    }
+    for(int row=0; row<rows; row++) {
+        const double* sums = rowSums + row*stride;
+        this->squaredError += sums[stride - 1];
+        for(int p=0; p<params; p++) {
+            delta[p] += sums[p];
+            for(int q=p; q<params; q++) {
+                hessian[p*params + q] += sums[params + p*params + q];
+            }
+        }
+    }
+    this->squaredError /= count;
+    for(int p=0; p<params; p++) {
+        for(int q=0; q<p; q++) {
+            hessian[p*params + q] = hessian[q*params + p];
+        }
+    }
+
+    // a singular system, like an untextured template on an untextured frame, gives no update
+    return solveCholesky(hessian, delta, params);
+}
+
+namespace Stick {
+    template class ESMT<double>;
+    template class ESMT<float>;
+}
@@ -1,106 +1,771 @@
 #include "tracker/inverse_compositional.hpp"
 
 #include "exceptions/not_initialized.hpp"
+#include "tracker/kernels.hpp"
+#include "tracker/sampling.hpp"
+
+#include <chrono>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace Stick;
 
-void InverseCompositional::initialize() {
-    this->calculateGradients();
-    this->calculateSteepest();
-    this->calculateHessianInv();
+// smallest template side kept in the pyramid
+static const int MinimumPyramidSize = 16;
+// the adaptive iteration cap never drops below this many iterations per level
+static const int MinimumIterationsPerLevel = 4;
+
+typedef std::chrono::steady_clock Clock;
 
-    this->errorImage = cv::Mat::zeros(this->templateImage.size(), cv::DataType<double>::type);
+// maps a full resolution pose into the coordinates of a level downsampled by scale
+static inline cv::Matx33d scalePose(const cv::Matx33d& pose, double scale) {
+    cv::Matx33d scaled = pose;
+    scaled(0, 2) *= scale;
+    scaled(1, 2) *= scale;
+    scaled(2, 0) /= scale;
+    scaled(2, 1) /= scale;
+    return scaled;
 }
 
-void InverseCompositional::track(const cv::Mat& image, const double scale) {
-    int width = this->templateImage.size().width;
-    int height = this->templateImage.size().height;
-    int params = this->model->getParameterSize();
+// index i of a row or column of n pixels reflected at the border like cv::BORDER_REFLECT_101
+static inline int reflect101(int i, int n) {
+    if( n == 1 ) {
+        return 0;
+    }
+    while( i < 0 || i >= n ) {
+        i = i < 0 ? -i : 2*n - 2 - i;
+    }
+    return i;
+}
 
-    this->poseTrace.clear();
-    for(int i=0; i<this->maxIteration; i++) {
-        this->calculateTransformedImage(image, this->templateImage.size());
-        for(int y=0; y<height; y++) {
-            for(int x=0; x<width; x++) {
-                cv::Point pt(x, y);
-                this->errorImage.at<double>(pt)
-                    = ((double)this->transformedImage.at<unsigned char>(pt)
-                    - (double)this->templateImage.at<unsigned char>(pt)) * scale;
+// horizontal 1 4 6 4 1 pass of pyrDown() at every other pixel of a source row
+static void pyrDownRow(const unsigned char* source, int width, int* row, int columns) {
+    for(int x=0; x<columns; x++) {
+        int c = 2*x;
+        if( c >= 2 && c+2 < width ) {
+            row[x] = source[c-2] + 4*(source[c-1] + source[c+1]) + 6*source[c] + source[c+2];
+        } else {
+            row[x] = source[reflect101(c-2, width)] + 4*(source[reflect101(c-1, width)] + source[reflect101(c+1, width)])
+                + 6*source[c] + source[reflect101(c+2, width)];
+        }
+    }
+}
+
+// cv::pyrDown of an 8 bit single channel image into destination, which already has the size of the result,
+// with the same 5x5 gaussian, border and rounding. cv::pyrDown allocates its row buffers on every call,
+// here the horizontal passes of the five source rows of an output row are kept in rows (5 * destination.cols)
+static void pyrDown(const cv::Mat& source, cv::Mat& destination, int* rows) {
+    int cached[5] = {-1, -1, -1, -1, -1};
+    for(int y=0; y<destination.rows; y++) {
+        // the source rows of an output row are five consecutive rows, or fewer reflected at the border
+        const int* taps[5];
+        for(int k=0; k<5; k++) {
+            int sy = reflect101(2*y + k - 2, source.rows);
+            int* row = rows + (sy % 5)*destination.cols;
+            if( cached[sy % 5] != sy ) {
+                pyrDownRow(source.ptr<unsigned char>(sy), source.cols, row, destination.cols);
+                cached[sy % 5] = sy;
             }
+            taps[k] = row;
+        }
+        unsigned char* out = destination.ptr<unsigned char>(y);
+        for(int x=0; x<destination.cols; x++) {
+            out[x] = (unsigned char)((taps[0][x] + 4*(taps[1][x] + taps[3][x]) + 6*taps[2][x] + taps[4][x] + 128) >> 8);
         }
-        cv::Mat reshapedError = this->errorImage.reshape(0, width*height);
+    }
+}
+
 
-        cv::Mat pose = this->model->get();
-        cv::Mat delta = this->hessianInv * (this->steepest * reshapedError);
-        cv::Mat deltaPose = cv::Mat::eye(pose.size(), cv::DataType<double>::type);
-        for(int i=0; i<delta.size().area(); i++) {
-            deltaPose.at<double>(i) += delta.at<double>(i);
+template<typename T>
+void InverseCompositionalT<T>::initialize() {
+    std::shared_ptr<TemplateData> templateData = std::make_shared<TemplateData>();
+    this->buildTemplateData(*templateData, this->templateImage);
+    this->dropTemplateRequests();
+    this->setTemplateData(templateData);
+}
+
+template<typename T>
+bool InverseCompositionalT<T>::initialize(const std::string& cachePath) {
+    uint64_t key = this->getTemplateKey();
+    std::shared_ptr<const TemplateData> cached = TemplateCache::Load(cachePath, key);
+    if( cached ) {
+        this->dropTemplateRequests();
+        this->setTemplateData(cached);
+        return true;
+    }
+
+    std::shared_ptr<TemplateData> templateData = std::make_shared<TemplateData>();
+    this->buildTemplateData(*templateData, this->templateImage);
+    TemplateCache::Save(cachePath, *templateData, key);
+    this->dropTemplateRequests();
+    this->setTemplateData(templateData);
+    return false;
+}
+
+template<typename T>
+uint64_t InverseCompositionalT<T>::getTemplateKey() const {
+    std::string configuration = instant::Utils::String::Format("%s:%s:%d:%d:%d:%.17g", this->getName().c_str(),
+            this->model->getName().c_str(), this->model->getParameterSize(), cv::DataType<T>::depth, this->pyramidLevel, this->pixelFraction);
+    return TemplateCache::Hash(this->templateImage, configuration);
+}
+
+template<typename T>
+std::shared_future<void> InverseCompositionalT<T>::initializeAsync(const cv::Mat& image) {
+    if(image.channels() != 1) {
+        throw MakeClassException(InvalidParameters, "template image must be a single channel");
+    }
+    TemplateRequest request;
+    request.image = image.clone();
+    request.promise = std::make_shared<std::promise<void> >();
+    std::shared_future<void> future = request.promise->get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(this->builderMutex);
+        request.id = ++this->latestRequest;
+        this->requests.push_back(request);
+        if( !this->builder.joinable() ) {
+            this->builder = std::thread(&InverseCompositionalT<T>::buildRequests, this);
         }
+    }
+    this->requested.notify_one();
+    return future;
+}
 
-        this->model->set(deltaPose);
-        cv::Mat deltaInv = this->model->inverse();
+template<typename T>
+bool InverseCompositionalT<T>::updateTemplate() {
+    std::shared_ptr<const TemplateData> templateData;
+    {
+        std::lock_guard<std::mutex> lock(this->builderMutex);
+        templateData.swap(this->builtTemplate);
+    }
+    if( !templateData ) {
+        return false;
+    }
+    this->setTemplateData(templateData);
+    return true;
+}
 
-        this->model->set(pose);
-        this->model->compose(deltaInv);
-        this->poseTrace.push_back(this->model->get());
+template<typename T>
+void InverseCompositionalT<T>::buildRequests() {
+    while( true ) {
+        TemplateRequest request;
+        {
+            std::unique_lock<std::mutex> lock(this->builderMutex);
+            this->requested.wait(lock, [this]() { return this->stoppingBuilder || !this->requests.empty(); });
+            if( this->stoppingBuilder ) {
+                return;
+            }
+            request = this->requests.front();
+            this->requests.pop_front();
+            if( request.id != this->latestRequest ) {
+                request.promise->set_value();
+                continue;
+            }
+        }
 
-        double sumOfComposeDelta = -2.0;
-        for(int p=0; p<params; p++) {
-            sumOfComposeDelta += std::abs(deltaInv.at<double>(p));
+        try {
+            std::shared_ptr<TemplateData> templateData = std::make_shared<TemplateData>();
+            this->buildTemplateData(*templateData, request.image);
+            {
+                std::lock_guard<std::mutex> lock(this->builderMutex);
+                if( request.id == this->latestRequest ) {
+                    this->builtTemplate = templateData;
+                }
+            }
+            request.promise->set_value();
+        } catch(...) {
+            request.promise->set_exception(std::current_exception());
         }
-       
-        this->iter = i;
+    }
+}
+
+// requests still queued are dropped, their futures report a broken promise
+template<typename T>
+void InverseCompositionalT<T>::stopBuilder() {
+    {
+        std::lock_guard<std::mutex> lock(this->builderMutex);
+        this->stoppingBuilder = true;
+    }
+    this->requested.notify_all();
+    if( this->builder.joinable() ) {
+        this->builder.join();
+    }
+}
+
+template<typename T>
+void InverseCompositionalT<T>::dropTemplateRequests() {
+    std::lock_guard<std::mutex> lock(this->builderMutex);
+    this->latestRequest++;
+    this->builtTemplate.reset();
+}
+
+template<typename T>
+void InverseCompositionalT<T>::buildTemplateData(TemplateData& templateData, const cv::Mat& image) {
+    templateData.modelName = this->model->getName();
+    templateData.parameterSize = this->model->getParameterSize();
+    templateData.depth = cv::DataType<T>::depth;
+    templateData.pixelFraction = this->pixelFraction;
+
+    this->buildTemplatePyramid(templateData, image);
+    for(Level& level : templateData.levels) {
+        this->calculateGradients(level);
+        this->calculateSteepest(level);
+        this->selectPixels(level);
+        this->calculateHessianInv(level);
+    }
+}
+
+template<typename T>
+void InverseCompositionalT<T>::setTemplateData(const std::shared_ptr<const TemplateData>& templateData) {
+    if( !templateData || templateData->levels.empty() ) {
+        throw MakeClassException(InvalidParameters, "template data is empty");
+    }
+    if( templateData->modelName != this->model->getName() || templateData->parameterSize != this->model->getParameterSize() ) {
+        throw MakeClassException(InvalidParameters, instant::Utils::String::Format("template data built for another model (input:%s, target:%s)",
+                    templateData->modelName.c_str(), this->model->getName().c_str()));
+    }
+    if( templateData->depth != cv::DataType<T>::depth ) {
+        throw MakeClassException(InvalidParameters, "template data built for another scalar type");
+    }
+
+    this->templateData = templateData;
+    this->templateImage = templateData->levels[0].templateImage;
+    this->allocateBuffers();
+    this->historyCount = 0;
+}
+
+template<typename T>
+int InverseCompositionalT<T>::getIterationCap() const {
+    int cap = this->maxIteration * this->templateData->levels.size();
+    if( !this->adaptiveIterations || this->historyCount < IterationHistorySize ) {
+        return cap;
+    }
+
+    // twice the most any recent frame needed: a frame going past it is most likely diverging
+    int recent = 0;
+    for(int i=0; i<IterationHistorySize; i++) {
+        recent = std::max(recent, this->iterationHistory[i]);
+    }
+    int minimum = MinimumIterationsPerLevel * this->templateData->levels.size();
+    return std::min(cap, std::max(minimum, 2*recent));
+}
+
+template<typename T>
+void InverseCompositionalT<T>::allocateBuffers() {
+    int params = this->model->getParameterSize();
+    cv::Size size = this->templateData->levels[0].templateImage.size();
+
+    this->steepestError.assign(params, 0.0);
+    this->delta.assign(params, 0.0);
+    this->rowSums.assign(size.height*(params + 1), 0.0);
+    // samples, then the errors padded to whole tiles, then the lanes of every parameter
+    int tiles = this->templateData->levels[0].getTilesPerRow();
+    this->rowBuffers.assign(this->threads, std::vector<T>(size.width + (tiles + params)*Kernels::TileSize));
+    this->poseTrace.clear();
+    this->poseTrace.reserve(this->maxIteration * this->templateData->levels.size());
+}
+
+template<typename T>
+T* InverseCompositionalT<T>::getRowBuffer() {
+#ifdef _OPENMP
+    return &this->rowBuffers[omp_get_thread_num()][0];
+#else
+    return &this->rowBuffers[0][0];
+#endif
+}
+
+// the coarse-to-fine iterations of the frame in the image pyramid from the current pose, at most iterationCap
+// and within timeBudget milliseconds of start (0 for none). sets the pose, status, iter and poseTrace,
+// returns the iterations made
+template<typename T>
+int InverseCompositionalT<T>::iterate(double scale, const std::chrono::steady_clock::time_point& start, double timeBudget, int iterationCap) {
+    int iteration = 0;
+    this->iter = -1;
+    this->status = MaxIteration;
+    this->poseTrace.clear();
+    bool solved = true;
+    for(int l=this->templateData->levels.size()-1; l>=0 && this->status != TimedOut && solved; l--) {
+        const Level& level = this->templateData->levels[l];
+        cv::Size size = level.templateImage.size();
+        bool converged = false;
+
+        // lowest error pose of this level, handed back when the time budget runs out
+        double bestError = std::numeric_limits<double>::max();
+        cv::Matx33d bestPose = this->model->getMatx();
+
+        // the steepest descent images are centred on the template, the pose is not
+        double cx = (double)size.width/2.0;
+        double cy = (double)size.height/2.0;
+        cv::Matx33d centre(1.0, 0.0, cx, 0.0, 1.0, cy, 0.0, 0.0, 1.0);
+        cv::Matx33d centreInv(1.0, 0.0, -cx, 0.0, 1.0, -cy, 0.0, 0.0, 1.0);
+
+        for(int i=0; i<this->maxIteration && iteration<iterationCap; i++) {
+            // stops before an iteration that would not fit into the budget, at the mean cost of the ones so far
+            if( timeBudget > 0.0 && iteration > 0 ) {
+                double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                if( elapsed + elapsed/iteration > timeBudget ) {
+                    this->model->setMatx(bestPose);
+                    this->status = TimedOut;
+                    break;
+                }
+            }
+
+            solved = this->calculateDelta(l, this->calculateLevelPose(l), scale, &this->delta[0]);
+            if( this->squaredError < bestError ) {
+                bestError = this->squaredError;
+                bestPose = this->model->getMatx();
+            }
+            // no update, not a converged one: the frame ends with the pose it has
+            if( !solved ) {
+                this->iter = iteration++;
+                break;
+            }
+
+            cv::Matx33d deltaInv = this->model->inverseDelta(&this->delta[0]);
+            // shortened to maxStep along the same direction, measured at the template corners of this level
+            if( this->maxStep > 0.0 ) {
+                double longest = 0.0;
+                for(int c=0; c<4; c++) {
+                    cv::Vec3d corner((c & 1) ? cx : -cx, (c & 2) ? cy : -cy, 1.0);
+                    cv::Vec3d moved = deltaInv * corner;
+                    longest = std::max(longest, std::hypot(moved[0]/moved[2] - corner[0], moved[1]/moved[2] - corner[1]));
+                }
+                if( longest > this->maxStep ) {
+                    for(double& d : this->delta) {
+                        d *= this->maxStep / longest;
+                    }
+                    deltaInv = this->model->inverseDelta(&this->delta[0]);
+                }
+            }
+            this->model->compose(scalePose(centre * deltaInv * centreInv, 1.0/level.scale));
+            this->poseTrace.push_back(this->model->getMatx());
+
+            // measured on the pose entries so the threshold means the same for every model
+            double sumOfComposeDelta = -2.0;
+            for(int p=0; p<8; p++) {
+                sumOfComposeDelta += std::abs(deltaInv.val[p]);
+            }
+
+            this->iter = iteration++;
+            this->sumOfComposeDelta = sumOfComposeDelta;
+            if( sumOfComposeDelta < this->thresholdSumOfComposeDelta ) {
+                converged = true;
+                break;
+            }
+        }
+        if( l == 0 && converged ) {
+            this->status = Converged;
+        }
+    }
+    return iteration;
+}
+
+template<typename T>
+void InverseCompositionalT<T>::track(const cv::Mat& image, const double scale) {
+    this->updateTemplate();
+    if( !this->templateData ) {
+        throw MakeClassException(NotInitialized, "tracker not initialized");
+    }
+    if( this->rowBuffers.size() < this->threads ) {
+        this->allocateBuffers();
+    }
+    Clock::time_point start = Clock::now();
+    // the region is placed by the prediction itself, ahead of predictPose()
+    this->buildImagePyramid(image);
+    cv::Matx33d previous = this->model->getMatx();
+    this->predictPose();
+
+    int iterationCap = this->getIterationCap();
+    int iteration = this->iterate(scale, start, this->timeBudget, iterationCap);
+
+    // the same frame again from the previous pose, then everything is set back to the predicted run
+    this->savedIterations = 0;
+    if( this->measurePrediction && this->predictor ) {
+        cv::Matx33d pose = this->model->getMatx();
+        std::vector<cv::Matx33d> poseTrace;
+        poseTrace.swap(this->poseTrace);
+        int iter = this->iter;
+        Status status = this->status;
+        double sumOfComposeDelta = this->sumOfComposeDelta;
+        double squaredError = this->squaredError;
+
+        this->model->setMatx(previous);
+        this->savedIterations = this->iterate(scale, Clock::now(), 0.0, iterationCap) - iteration;
+
+        this->model->setMatx(pose);
+        this->poseTrace.swap(poseTrace);
+        this->iter = iter;
+        this->status = status;
         this->sumOfComposeDelta = sumOfComposeDelta;
-        if( sumOfComposeDelta < this->thresholdSumOfComposeDelta ) {
+        this->squaredError = squaredError;
+    }
+
+    // a frame the cap stopped needed at least the whole cap, so every capped frame doubles the cap until
+    // the frames fit again. a timed out frame needed at least the iterations it had
+    bool capped = iterationCap < this->maxIteration * (int)this->templateData->levels.size() && iteration >= iterationCap;
+    if( this->status == Converged || this->status == TimedOut || capped ) {
+        this->iterationHistory[this->historyCount % IterationHistorySize] = iteration;
+        this->historyCount++;
+    }
+    this->updatePredictor();
+
+    if( this->keepDebugImages ) {
+        cv::Mat transformed, reference;
+        this->warpImage(0, this->transformedImage);
+        this->transformedImage.convertTo(transformed, cv::DataType<T>::type);
+        this->templateData->levels[0].templateImage.convertTo(reference, cv::DataType<T>::type);
+        this->errorImage = (transformed - reference) * scale;
+    }
+}
+
+template<typename T>
+void InverseCompositionalT<T>::buildTemplatePyramid(TemplateData& templateData, const cv::Mat& image) {
+    if(image.size().area() == 0) {
+        throw MakeClassException(NotInitialized, "template image not initialized");
+    }
+
+    std::vector<Level>& levels = templateData.levels;
+    levels.clear();
+    levels.resize(1);
+    levels[0].scale = 1.0;
+    levels[0].templateImage = image;
+    for(int l=1; l<this->pyramidLevel; l++) {
+        const Level& finer = levels.back();
+        cv::Size size = finer.templateImage.size();
+        if( std::min(size.width, size.height)/2 < MinimumPyramidSize ) {
             break;
         }
+
+        Level coarser;
+        coarser.scale = finer.scale / 2.0;
+        coarser.templateImage.create((size.height + 1)/2, (size.width + 1)/2, CV_8UC1);
+        std::vector<int> rows(5*coarser.templateImage.cols);
+        pyrDown(finer.templateImage, coarser.templateImage, &rows[0]);
+        levels.push_back(coarser);
+    }
+}
+
+template<typename T>
+cv::Rect InverseCompositionalT<T>::getRegion(const cv::Size& imageSize) const {
+    cv::Rect frame(0, 0, imageSize.width, imageSize.height);
+    if( this->regionMargin == 0 || !this->templateData ) {
+        return frame;
+    }
+
+    // the pose track() starts from
+    cv::Matx33d pose = this->model->getMatx();
+    if( this->predictor ) {
+        pose = this->predictor->predict(pose);
+    }
+    cv::Size templateSize = this->templateData->levels[0].templateImage.size();
+    pose(0, 2) += imageSize.width/2 - templateSize.width/2;
+    pose(1, 2) += imageSize.height/2 - templateSize.height/2;
+
+    double left = std::numeric_limits<double>::max(), top = left;
+    double right = -left, bottom = -left;
+    for(int c=0; c<4; c++) {
+        double x = (c == 1 || c == 2) ? templateSize.width : 0.0;
+        double y = (c >= 2) ? templateSize.height : 0.0;
+        double z = pose(2, 0)*x + pose(2, 1)*y + pose(2, 2);
+        if( !(z > 0.0) ) {
+            return frame;
+        }
+        double u = (pose(0, 0)*x + pose(0, 1)*y + pose(0, 2)) / z;
+        double v = (pose(1, 0)*x + pose(1, 1)*y + pose(1, 2)) / z;
+        left = std::min(left, u);
+        right = std::max(right, u);
+        top = std::min(top, v);
+        bottom = std::max(bottom, v);
+    }
+
+    // clamped before the integer conversion, and the origin kept on the grid of the coarsest level
+    // so every level of the region pyramid lines up with the one of the whole frame
+    int grid = 1 << (this->templateData->levels.size() - 1);
+    int x0 = (int)std::max(0.0, std::min((double)imageSize.width, std::floor(left) - this->regionMargin));
+    int y0 = (int)std::max(0.0, std::min((double)imageSize.height, std::floor(top) - this->regionMargin));
+    int x1 = (int)std::max(0.0, std::min((double)imageSize.width, std::ceil(right) + this->regionMargin + 1));
+    int y1 = (int)std::max(0.0, std::min((double)imageSize.height, std::ceil(bottom) + this->regionMargin + 1));
+    x0 -= x0 % grid;
+    y0 -= y0 % grid;
+    if( x1 <= x0 || y1 <= y0 ) {
+        return frame;
+    }
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+template<typename T>
+void InverseCompositionalT<T>::blurRegion(const cv::Mat& image, cv::Mat& blurred, const cv::Size& kernelSize, double sigma) const {
+    if( blurred.rows != image.rows || blurred.cols != image.cols || blurred.type() != image.type() ) {
+        blurred = cv::Mat(image.rows, image.cols, image.type());
+    }
+    cv::Rect region = this->getRegion(image.size());
+    cv::Mat target = blurred(region);
+    cv::GaussianBlur(image(region), target, kernelSize, sigma, sigma);
+}
+
+template<typename T>
+void InverseCompositionalT<T>::buildImagePyramid(const cv::Mat& image) {
+    this->imageSize = image.size();
+    this->region = this->getRegion(image.size());
+    this->imagePyramid.resize(this->templateData->levels.size());
+    this->pyramidBuffers.resize(this->templateData->levels.size());
+    this->imagePyramid[0] = image(this->region);
+    cv::Size frame = image.size();
+    if( this->imagePyramid.size() > 1 ) {
+        this->pyramidRows.resize(5*((frame.width + 1)/2));
+    }
+    for(int l=1; l<this->imagePyramid.size(); l++) {
+        frame = cv::Size((frame.width + 1)/2, (frame.height + 1)/2);
+        this->pyramidBuffers[l].create(frame, image.type());
+        const cv::Mat& finer = this->imagePyramid[l-1];
+        this->imagePyramid[l] = this->pyramidBuffers[l](cv::Rect(0, 0, (finer.cols + 1)/2, (finer.rows + 1)/2));
+        pyrDown(finer, this->imagePyramid[l], &this->pyramidRows[0]);
+    }
+}
+
+template<typename T>
+cv::Matx33d InverseCompositionalT<T>::calculateLevelPose(int l) const {
+    cv::Size templateSize = this->templateData->levels[0].templateImage.size();
+    int dx = this->imageSize.width/2 - templateSize.width/2 - this->region.x;
+    int dy = this->imageSize.height/2 - templateSize.height/2 - this->region.y;
+
+    cv::Matx33d pose = this->model->getMatx();
+    pose(0, 2) += dx;
+    pose(1, 2) += dy;
+
+    return scalePose(pose, this->templateData->levels[l].scale);
+}
+
+template<typename T>
+void InverseCompositionalT<T>::warpImage(int l, cv::Mat& transformedImage) const {
+    cv::warpPerspective(this->imagePyramid[l], transformedImage, this->calculateLevelPose(l).inv(), this->templateData->levels[l].templateImage.size());
+}
+
+template<typename T>
+bool InverseCompositionalT<T>::calculateDelta(int l, const cv::Matx33d& warp, double scale, double* delta) {
+    int params = this->model->getParameterSize();
+    const double* hessianInv = this->templateData->levels[l].hessianInv.ptr<double>(0);
+
+    this->accumulateSteepestError(l, warp, scale, &this->steepestError[0]);
+    for(int p=0; p<params; p++) {
+        double sum = 0.0;
+        for(int q=0; q<params; q++) {
+            sum += hessianInv[p*params + q] * this->steepestError[q];
+        }
+        delta[p] = sum;
     }
+    return true;
 }
 
-void InverseCompositional::calculateGradients(double scale){
-    if(this->templateImage.size().area() == 0) {
+// single pass over the template rows: warp, sample, subtract and accumulate steepest^T * error.
+// with selected pixels the rows are blocks of template width over the compact pixel list
+template<typename T>
+void InverseCompositionalT<T>::accumulateSteepestError(int l, const cv::Matx33d& warp, double scale, double* steepestError) {
+    const Level& level = this->templateData->levels[l];
+    const cv::Mat& image = this->imagePyramid[l];
+    int width = level.templateImage.size().width;
+    int params = this->model->getParameterSize();
+    int count = level.getCount();
+    int rows = (count + width - 1) / width;
+    int tiles = level.getTilesPerRow();
+    bool selected = !level.pixels.empty();
+
+    const double* h = warp.val;
+
+    // rows are split across threads, the per row sums are reduced in row order afterwards
+    // so the result does not depend on the number of threads
+    const Kernels::Table& kernels = Kernels::get();
+    double* rowSums = &this->rowSums[0];
+    int stride = params + 1;
+    this->parallelRows([&]() {
+        T* sampled = this->getRowBuffer();
+        T* error = sampled + width;
+        T* lanes = error + tiles*Kernels::TileSize;
+        #pragma omp for schedule(static)
+        for(int row=0; row<rows; row++) {
+            int begin = row*width;
+            int length = std::min(width, count - begin);
+            const int* pixels = selected ? &level.pixels[begin] : NULL;
+            for(int i=0; i<length; i++) {
+                int x = i, y = row;
+                if( pixels ) {
+                    x = pixels[i] % width;
+                    y = pixels[i] / width;
+                }
+                sampled[i] = sampleWarped(image, h, x, y);
+            }
+            const unsigned char* reference = selected ? &level.reference[begin] : level.templateImage.ptr<unsigned char>(row);
+            Kernels::errorRow(kernels, sampled, reference, length, scale, error);
+            std::fill(error + length, error + tiles*Kernels::TileSize, (T)0);
+
+            // the tiles of the row are read once, in order, for all parameters together
+            std::fill(lanes, lanes + params*Kernels::TileSize, (T)0);
+            Kernels::tileDot(kernels, level.steepest.ptr<T>(row*tiles), error, tiles, params, lanes);
+            for(int p=0; p<params; p++) {
+                rowSums[row*stride + p] = Kernels::reduceLanes(lanes + p*Kernels::TileSize);
+            }
+            rowSums[row*stride + params] = Kernels::dot(kernels, error, error, length);
+        }
+    });
+
+    for(int p=0; p<params; p++) {
+        steepestError[p] = 0.0;
+    }
+    this->squaredError = 0.0;
+    for(int row=0; row<rows; row++) {
+        for(int p=0; p<params; p++) {
+            steepestError[p] += rowSums[row*stride + p];
+        }
+        this->squaredError += rowSums[row*stride + params];
+    }
+    this->squaredError /= count;
+}
+
+template<typename T>
+void InverseCompositionalT<T>::calculateGradients(Level& level, double scale){
+    cv::Mat image = level.templateImage;
+    if(image.size().area() == 0) {
         throw MakeClassException(NotInitialized, "template image not initialized");
     }
 
-    cv::Mat image = this->templateImage;
-    this->gradients = cv::Mat::zeros(cv::Size(image.size().area(), 2), cv::DataType<double>::type);
+    level.gradients = cv::Mat::zeros(cv::Size(image.size().area(), 2), cv::DataType<T>::type);
 
     int width = image.size().width;
     int height = image.size().height;
+    const Kernels::Table& kernels = Kernels::get();
+    #pragma omp parallel for num_threads(this->threads) if(this->threads > 1) schedule(static)
     for(int y=1; y<height-1; y++) {
-        for(int x=1; x<width-1; x++) {
-            this->gradients.at<double>(cv::Point(y*width+x, 0)) = ((double)image.at<unsigned char>(y,x+1) - (double)image.at<unsigned char>(y,x-1)) * scale;
-            this->gradients.at<double>(cv::Point(y*width+x, 1)) = ((double)image.at<unsigned char>(y+1,x) - (double)image.at<unsigned char>(y-1,x)) * scale;
-        }
+        Kernels::gradientRow(kernels, image.ptr<unsigned char>(y-1), image.ptr<unsigned char>(y), image.ptr<unsigned char>(y+1),
+                width, scale, level.gradients.ptr<T>(0) + y*width, level.gradients.ptr<T>(1) + y*width);
     }
 }
 
-void InverseCompositional::calculateSteepest() {
-    int width = this->templateImage.size().width;
-    int height = this->templateImage.size().height;
+template<typename T>
+void InverseCompositionalT<T>::calculateSteepest(Level& level) {
+    int width = level.templateImage.size().width;
+    int height = level.templateImage.size().height;
     int params = this->model->getParameterSize();
-    this->steepest = cv::Mat::zeros(cv::Size(width*height, params), cv::DataType<double>::type);
-
-    for(int y=0; y<height; y++) {
-        for(int x=0; x<width; x++) {
-            cv::Mat in = cv::Mat::ones(cv::Size(1, 3), cv::DataType<double>::type);
-            in.at<double>(0) = (double)x - (double)width/2.0;
-            in.at<double>(1) = (double)y - (double)height/2.0;
-            in.at<double>(2) = 1.0;
-            
-            cv::Mat out = this->model->jacobian(in);
-            for(int p=0; p<this->model->getParameterSize(); p++) {
-                this->steepest.at<double>(cv::Point(y*width+x, p))
-                    = out.at<double>(cv::Point(p, 0)) * this->gradients.at<double>(cv::Point(y*width+x, 0))
-                    + out.at<double>(cv::Point(p, 1)) * this->gradients.at<double>(cv::Point(y*width+x, 1));
+    int tiles = level.getTilesPerRow();
+    level.pixels.clear();
+    level.steepest = cv::Mat::zeros(cv::Size(params*Kernels::TileSize, height*tiles), cv::DataType<T>::type);
+
+    // jacobians of the current template row, laid out per parameter for the row kernel.
+    // one virtual call per row, static models fill it without allocating.
+    // the row is computed per parameter, then interleaved into its tiles
+    const Kernels::Table& kernels = Kernels::get();
+    #pragma omp parallel num_threads(this->threads) if(this->threads > 1)
+    {
+        std::vector<double> row(2*params*width);
+        std::vector<T> jacobians(2*params*width);
+        std::vector<T> values(params*width);
+        #pragma omp for schedule(static)
+        for(int y=0; y<height; y++) {
+            this->templateModel->jacobianRow(-(double)width/2.0, (double)y - (double)height/2.0, width, &row[0]);
+            std::copy(row.begin(), row.end(), jacobians.begin());
+
+            const T* dx = level.gradients.ptr<T>(0) + y*width;
+            const T* dy = level.gradients.ptr<T>(1) + y*width;
+            for(int p=0; p<params; p++) {
+                Kernels::steepestRow(kernels, &jacobians[(2*p)*width], &jacobians[(2*p+1)*width], dx, dy, width, &values[p*width]);
+            }
+            for(int x=0; x<width; x++) {
+                T* tile = level.steepest.ptr<T>(y*tiles + x/Kernels::TileSize);
+                for(int p=0; p<params; p++) {
+                    tile[p*Kernels::TileSize + x%Kernels::TileSize] = values[p*width + x];
+                }
             }
+        }
+    }
+}
+
+// keeps the pixels contributing most to the Hessian: each pixel is scored by its steepest descent
+// values squared relative to the Hessian diagonal, so every parameter weighs the same
+template<typename T>
+void InverseCompositionalT<T>::selectPixels(Level& level) {
+    level.pixels.clear();
+    level.reference.clear();
+
+    int params = this->model->getParameterSize();
+    int total = level.getCount();
+    int count = std::max(params, (int)(this->pixelFraction * total + 0.5));
+    if( count >= total ) {
+        return;
+    }
+
+    std::vector<double> diagonal(params, 0.0);
+    for(int p=0; p<params; p++) {
+        for(int i=0; i<total; i++) {
+            double value = level.steepestAt<T>(p, i);
+            diagonal[p] += value * value;
+        }
+    }
+
+    std::vector<double> scores(total, 0.0);
+    for(int p=0; p<params; p++) {
+        double weight = diagonal[p] > 0.0 ? 1.0/diagonal[p] : 0.0;
+        for(int i=0; i<total; i++) {
+            double value = level.steepestAt<T>(p, i);
+            scores[i] += value * value * weight;
+        }
+    }
 
+    std::vector<int> order(total);
+    for(int i=0; i<total; i++) {
+        order[i] = i;
+    }
+    std::nth_element(order.begin(), order.begin() + count, order.end(), [&scores](int a, int b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    });
+    level.pixels.assign(order.begin(), order.begin() + count);
+    std::sort(level.pixels.begin(), level.pixels.end());
+
+    // the compact list is tiled in blocks of template width like the full template
+    int width = level.templateImage.size().width;
+    int tiles = level.getTilesPerRow();
+    int rows = (count + width - 1) / width;
+    cv::Mat steepest = cv::Mat::zeros(cv::Size(params*Kernels::TileSize, rows*tiles), cv::DataType<T>::type);
+    level.reference.resize(count);
+    for(int i=0; i<count; i++) {
+        int pixel = level.pixels[i];
+        int column = i % width;
+        T* tile = steepest.ptr<T>((i / width)*tiles + column/Kernels::TileSize);
+        for(int p=0; p<params; p++) {
+            tile[p*Kernels::TileSize + column%Kernels::TileSize] = level.steepestAt<T>(p, pixel);
         }
+        level.reference[i] = level.templateImage.at<unsigned char>(pixel / width, pixel % width);
     }
+    level.steepest = steepest;
 }
 
-void InverseCompositional::calculateHessianInv() {
-    cv::Mat temp = (this->steepest * this->steepest.t());
-    this->hessianInv = temp.inv();
+template<typename T>
+void InverseCompositionalT<T>::calculateHessianInv(Level& level) {
+    // accumulated tile by tile and inverted in double whatever the pixel type
+    int params = this->model->getParameterSize();
+    cv::Mat temp = cv::Mat::zeros(params, params, cv::DataType<double>::type);
+    double* hessian = temp.ptr<double>(0);
+    for(int t=0; t<level.steepest.size().height; t++) {
+        const T* tile = level.steepest.ptr<T>(t);
+        for(int p=0; p<params; p++) {
+            for(int q=p; q<params; q++) {
+                double sum = 0.0;
+                for(int k=0; k<Kernels::TileSize; k++) {
+                    sum += (double)tile[p*Kernels::TileSize + k] * tile[q*Kernels::TileSize + k];
+                }
+                hessian[p*params + q] += sum;
+            }
+        }
+    }
+    for(int p=0; p<params; p++) {
+        for(int q=0; q<p; q++) {
+            hessian[p*params + q] = hessian[q*params + p];
+        }
+    }
+    level.hessianInv = temp.inv();
 }
 
+namespace Stick {
+    template class InverseCompositionalT<double>;
+    template class InverseCompositionalT<float>;
+}
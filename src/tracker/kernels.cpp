@@ -0,0 +1,52 @@
+#include "tracker/kernels.hpp"
+
+using namespace Stick;
+
+static bool isSupported(const Kernels::Table& table) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if( &table == &Kernels::AVX512 ) {
+        return __builtin_cpu_supports("avx512f");
+    }
+    if( &table == &Kernels::AVX2 ) {
+        return __builtin_cpu_supports("avx2");
+    }
+    if( &table == &Kernels::SSE42 ) {
+        return __builtin_cpu_supports("sse4.2");
+    }
+    return &table == &Kernels::Scalar;
+#else
+    return &table == &Kernels::Scalar;
+#endif
+}
+
+static const Kernels::Table*& active() {
+    static const Kernels::Table* table = Kernels::getAvailable().back();
+    return table;
+}
+
+const Kernels::Table& Kernels::get() {
+    return *active();
+}
+
+std::vector<const Kernels::Table*> Kernels::getAvailable() {
+    const Table* tables[] = {&Scalar, &SSE42, &AVX2, &AVX512};
+
+    std::vector<const Table*> available;
+    for(const Table* table : tables) {
+        if( isSupported(*table) ) {
+            available.push_back(table);
+        }
+    }
+    return available;
+}
+
+bool Kernels::select(const std::string& name) {
+    for(const Table* table : getAvailable()) {
+        if( name == table->name ) {
+            active() = table;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,177 @@
+// built with -mavx2, only reached when the cpu reports avx2
+#include "tracker/kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cstring>
+#include <immintrin.h>
+#endif
+
+using namespace Stick;
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline __m128i load4(const unsigned char* p) {
+    int packed;
+    std::memcpy(&packed, p, sizeof(packed));
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+}
+
+static inline __m256i load8(const unsigned char* p) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p));
+}
+
+static void gradientRow(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+        int width, double scale, double* dx, double* dy) {
+    if( width <= 0 ) {
+        return;
+    }
+    dx[0] = dy[0] = 0.0;
+    dx[width-1] = dy[width-1] = 0.0;
+
+    int x = 1;
+    __m256d s = _mm256_set1_pd(scale);
+    for(; x+4<width; x+=4) {
+        __m128i gx = _mm_sub_epi32(load4(current+x+1), load4(current+x-1));
+        __m128i gy = _mm_sub_epi32(load4(next+x), load4(previous+x));
+        _mm256_storeu_pd(dx+x, _mm256_mul_pd(_mm256_cvtepi32_pd(gx), s));
+        _mm256_storeu_pd(dy+x, _mm256_mul_pd(_mm256_cvtepi32_pd(gy), s));
+    }
+    for(; x<width-1; x++) {
+        dx[x] = ((double)current[x+1] - (double)current[x-1]) * scale;
+        dy[x] = ((double)next[x] - (double)previous[x]) * scale;
+    }
+}
+
+static void steepestRow(const double* jx, const double* jy, const double* dx, const double* dy, int width, double* out) {
+    int x = 0;
+    for(; x+4<=width; x+=4) {
+        __m256d a = _mm256_mul_pd(_mm256_loadu_pd(jx+x), _mm256_loadu_pd(dx+x));
+        __m256d b = _mm256_mul_pd(_mm256_loadu_pd(jy+x), _mm256_loadu_pd(dy+x));
+        _mm256_storeu_pd(out+x, _mm256_add_pd(a, b));
+    }
+    for(; x<width; x++) {
+        out[x] = jx[x] * dx[x] + jy[x] * dy[x];
+    }
+}
+
+static void errorRow(const double* sampled, const unsigned char* reference, int width, double scale, double* error) {
+    int x = 0;
+    __m256d s = _mm256_set1_pd(scale);
+    for(; x+4<=width; x+=4) {
+        __m256d r = _mm256_cvtepi32_pd(load4(reference+x));
+        _mm256_storeu_pd(error+x, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(sampled+x), r), s));
+    }
+    for(; x<width; x++) {
+        error[x] = (sampled[x] - (double)reference[x]) * scale;
+    }
+}
+
+static double dot(const double* a, const double* b, int width) {
+    double lanes[8];
+    int x = 0;
+    __m256d low = _mm256_setzero_pd(), high = _mm256_setzero_pd();
+    for(; x+8<=width; x+=8) {
+        low  = _mm256_add_pd(low,  _mm256_mul_pd(_mm256_loadu_pd(a+x),   _mm256_loadu_pd(b+x)));
+        high = _mm256_add_pd(high, _mm256_mul_pd(_mm256_loadu_pd(a+x+4), _mm256_loadu_pd(b+x+4)));
+    }
+    _mm256_storeu_pd(lanes, low);
+    _mm256_storeu_pd(lanes+4, high);
+    for(; x<width; x++) {
+        lanes[x&7] += a[x] * b[x];
+    }
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+static void gradientRowFloat(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+        int width, float scale, float* dx, float* dy) {
+    if( width <= 0 ) {
+        return;
+    }
+    dx[0] = dy[0] = 0.0f;
+    dx[width-1] = dy[width-1] = 0.0f;
+
+    int x = 1;
+    __m256 s = _mm256_set1_ps(scale);
+    for(; x+8<width; x+=8) {
+        __m256i gx = _mm256_sub_epi32(load8(current+x+1), load8(current+x-1));
+        __m256i gy = _mm256_sub_epi32(load8(next+x), load8(previous+x));
+        _mm256_storeu_ps(dx+x, _mm256_mul_ps(_mm256_cvtepi32_ps(gx), s));
+        _mm256_storeu_ps(dy+x, _mm256_mul_ps(_mm256_cvtepi32_ps(gy), s));
+    }
+    for(; x<width-1; x++) {
+        dx[x] = (float)((int)current[x+1] - (int)current[x-1]) * scale;
+        dy[x] = (float)((int)next[x] - (int)previous[x]) * scale;
+    }
+}
+
+static void steepestRowFloat(const float* jx, const float* jy, const float* dx, const float* dy, int width, float* out) {
+    int x = 0;
+    for(; x+8<=width; x+=8) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(jx+x), _mm256_loadu_ps(dx+x));
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(jy+x), _mm256_loadu_ps(dy+x));
+        _mm256_storeu_ps(out+x, _mm256_add_ps(a, b));
+    }
+    for(; x<width; x++) {
+        out[x] = jx[x] * dx[x] + jy[x] * dy[x];
+    }
+}
+
+static void errorRowFloat(const float* sampled, const unsigned char* reference, int width, float scale, float* error) {
+    int x = 0;
+    __m256 s = _mm256_set1_ps(scale);
+    for(; x+8<=width; x+=8) {
+        __m256 r = _mm256_cvtepi32_ps(load8(reference+x));
+        _mm256_storeu_ps(error+x, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(sampled+x), r), s));
+    }
+    for(; x<width; x++) {
+        error[x] = (sampled[x] - (float)reference[x]) * scale;
+    }
+}
+
+static double dotFloat(const float* a, const float* b, int width) {
+    float lanes[8];
+    int x = 0;
+    __m256 acc = _mm256_setzero_ps();
+    for(; x+8<=width; x+=8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a+x), _mm256_loadu_ps(b+x)));
+    }
+    _mm256_storeu_ps(lanes, acc);
+    for(; x<width; x++) {
+        lanes[x&7] += a[x] * b[x];
+    }
+    return (((double)lanes[0] + lanes[4]) + ((double)lanes[2] + lanes[6])) + (((double)lanes[1] + lanes[5]) + ((double)lanes[3] + lanes[7]));
+}
+
+static void tileDot(const double* tiles, const double* error, int count, int params, double* lanes) {
+    for(int t=0; t<count; t++) {
+        const double* e = error + t*8;
+        __m256d low = _mm256_loadu_pd(e), high = _mm256_loadu_pd(e+4);
+        for(int p=0; p<params; p++) {
+            const double* tile = tiles + (t*params + p)*8;
+            double* l = lanes + p*8;
+            _mm256_storeu_pd(l,   _mm256_add_pd(_mm256_loadu_pd(l),   _mm256_mul_pd(_mm256_loadu_pd(tile),   low)));
+            _mm256_storeu_pd(l+4, _mm256_add_pd(_mm256_loadu_pd(l+4), _mm256_mul_pd(_mm256_loadu_pd(tile+4), high)));
+        }
+    }
+}
+
+static void tileDotFloat(const float* tiles, const float* error, int count, int params, float* lanes) {
+    for(int t=0; t<count; t++) {
+        __m256 e = _mm256_loadu_ps(error + t*8);
+        for(int p=0; p<params; p++) {
+            const float* tile = tiles + (t*params + p)*8;
+            float* l = lanes + p*8;
+            _mm256_storeu_ps(l, _mm256_add_ps(_mm256_loadu_ps(l), _mm256_mul_ps(_mm256_loadu_ps(tile), e)));
+        }
+    }
+}
+
+const Kernels::Table Kernels::AVX2 = {
+    "avx2", ::gradientRow, ::steepestRow, ::errorRow, ::dot, ::tileDot,
+    ::gradientRowFloat, ::steepestRowFloat, ::errorRowFloat, ::dotFloat, ::tileDotFloat
+};
+#else
+const Kernels::Table Kernels::AVX2 = {
+    "avx2", NULL, NULL, NULL, NULL, NULL,
+    NULL, NULL, NULL, NULL, NULL
+};
+#endif
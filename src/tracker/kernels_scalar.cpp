@@ -0,0 +1,98 @@
+#include "tracker/kernels.hpp"
+
+using namespace Stick;
+
+static void gradientRow(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+        int width, double scale, double* dx, double* dy) {
+    if( width <= 0 ) {
+        return;
+    }
+    dx[0] = dy[0] = 0.0;
+    dx[width-1] = dy[width-1] = 0.0;
+    for(int x=1; x<width-1; x++) {
+        dx[x] = ((double)current[x+1] - (double)current[x-1]) * scale;
+        dy[x] = ((double)next[x] - (double)previous[x]) * scale;
+    }
+}
+
+static void steepestRow(const double* jx, const double* jy, const double* dx, const double* dy, int width, double* out) {
+    for(int x=0; x<width; x++) {
+        out[x] = jx[x] * dx[x] + jy[x] * dy[x];
+    }
+}
+
+static void errorRow(const double* sampled, const unsigned char* reference, int width, double scale, double* error) {
+    for(int x=0; x<width; x++) {
+        error[x] = (sampled[x] - (double)reference[x]) * scale;
+    }
+}
+
+static double dot(const double* a, const double* b, int width) {
+    double lanes[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for(int x=0; x<width; x++) {
+        lanes[x&7] += a[x] * b[x];
+    }
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+static void gradientRowFloat(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+        int width, float scale, float* dx, float* dy) {
+    if( width <= 0 ) {
+        return;
+    }
+    dx[0] = dy[0] = 0.0f;
+    dx[width-1] = dy[width-1] = 0.0f;
+    for(int x=1; x<width-1; x++) {
+        dx[x] = (float)((int)current[x+1] - (int)current[x-1]) * scale;
+        dy[x] = (float)((int)next[x] - (int)previous[x]) * scale;
+    }
+}
+
+static void steepestRowFloat(const float* jx, const float* jy, const float* dx, const float* dy, int width, float* out) {
+    for(int x=0; x<width; x++) {
+        out[x] = jx[x] * dx[x] + jy[x] * dy[x];
+    }
+}
+
+static void errorRowFloat(const float* sampled, const unsigned char* reference, int width, float scale, float* error) {
+    for(int x=0; x<width; x++) {
+        error[x] = (sampled[x] - (float)reference[x]) * scale;
+    }
+}
+
+static double dotFloat(const float* a, const float* b, int width) {
+    float lanes[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for(int x=0; x<width; x++) {
+        lanes[x&7] += a[x] * b[x];
+    }
+    return (((double)lanes[0] + lanes[4]) + ((double)lanes[2] + lanes[6])) + (((double)lanes[1] + lanes[5]) + ((double)lanes[3] + lanes[7]));
+}
+
+static void tileDot(const double* tiles, const double* error, int count, int params, double* lanes) {
+    for(int t=0; t<count; t++) {
+        const double* e = error + t*8;
+        for(int p=0; p<params; p++) {
+            const double* tile = tiles + (t*params + p)*8;
+            for(int k=0; k<8; k++) {
+                lanes[p*8 + k] += tile[k] * e[k];
+            }
+        }
+    }
+}
+
+static void tileDotFloat(const float* tiles, const float* error, int count, int params, float* lanes) {
+    for(int t=0; t<count; t++) {
+        const float* e = error + t*8;
+        for(int p=0; p<params; p++) {
+            const float* tile = tiles + (t*params + p)*8;
+            for(int k=0; k<8; k++) {
+                lanes[p*8 + k] += tile[k] * e[k];
+            }
+        }
+    }
+}
+
+const Kernels::Table Kernels::Scalar = {
+    "scalar", ::gradientRow, ::steepestRow, ::errorRow, ::dot, ::tileDot,
+    ::gradientRowFloat, ::steepestRowFloat, ::errorRowFloat, ::dotFloat, ::tileDotFloat
+};
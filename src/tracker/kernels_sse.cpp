@@ -0,0 +1,184 @@
+// built with -msse4.2, only reached when the cpu reports sse4.2
+#include "tracker/kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cstring>
+#include <smmintrin.h>
+#endif
+
+using namespace Stick;
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline __m128i load4(const unsigned char* p) {
+    int packed;
+    std::memcpy(&packed, p, sizeof(packed));
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+}
+
+static void gradientRow(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+        int width, double scale, double* dx, double* dy) {
+    if( width <= 0 ) {
+        return;
+    }
+    dx[0] = dy[0] = 0.0;
+    dx[width-1] = dy[width-1] = 0.0;
+
+    int x = 1;
+    __m128d s = _mm_set1_pd(scale);
+    for(; x+4<width; x+=4) {
+        __m128i gx = _mm_sub_epi32(load4(current+x+1), load4(current+x-1));
+        __m128i gy = _mm_sub_epi32(load4(next+x), load4(previous+x));
+        _mm_storeu_pd(dx+x,   _mm_mul_pd(_mm_cvtepi32_pd(gx), s));
+        _mm_storeu_pd(dx+x+2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(gx, 8)), s));
+        _mm_storeu_pd(dy+x,   _mm_mul_pd(_mm_cvtepi32_pd(gy), s));
+        _mm_storeu_pd(dy+x+2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(gy, 8)), s));
+    }
+    for(; x<width-1; x++) {
+        dx[x] = ((double)current[x+1] - (double)current[x-1]) * scale;
+        dy[x] = ((double)next[x] - (double)previous[x]) * scale;
+    }
+}
+
+static void steepestRow(const double* jx, const double* jy, const double* dx, const double* dy, int width, double* out) {
+    int x = 0;
+    for(; x+2<=width; x+=2) {
+        __m128d a = _mm_mul_pd(_mm_loadu_pd(jx+x), _mm_loadu_pd(dx+x));
+        __m128d b = _mm_mul_pd(_mm_loadu_pd(jy+x), _mm_loadu_pd(dy+x));
+        _mm_storeu_pd(out+x, _mm_add_pd(a, b));
+    }
+    for(; x<width; x++) {
+        out[x] = jx[x] * dx[x] + jy[x] * dy[x];
+    }
+}
+
+static void errorRow(const double* sampled, const unsigned char* reference, int width, double scale, double* error) {
+    int x = 0;
+    __m128d s = _mm_set1_pd(scale);
+    for(; x+4<=width; x+=4) {
+        __m128i r = load4(reference+x);
+        _mm_storeu_pd(error+x,   _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(sampled+x),   _mm_cvtepi32_pd(r)), s));
+        _mm_storeu_pd(error+x+2, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(sampled+x+2), _mm_cvtepi32_pd(_mm_srli_si128(r, 8))), s));
+    }
+    for(; x<width; x++) {
+        error[x] = (sampled[x] - (double)reference[x]) * scale;
+    }
+}
+
+static double dot(const double* a, const double* b, int width) {
+    double lanes[8];
+    int x = 0;
+    __m128d acc[4] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+    for(; x+8<=width; x+=8) {
+        for(int k=0; k<4; k++) {
+            acc[k] = _mm_add_pd(acc[k], _mm_mul_pd(_mm_loadu_pd(a+x+2*k), _mm_loadu_pd(b+x+2*k)));
+        }
+    }
+    for(int k=0; k<4; k++) {
+        _mm_storeu_pd(lanes+2*k, acc[k]);
+    }
+    for(; x<width; x++) {
+        lanes[x&7] += a[x] * b[x];
+    }
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+static void gradientRowFloat(const unsigned char* previous, const unsigned char* current, const unsigned char* next,
+        int width, float scale, float* dx, float* dy) {
+    if( width <= 0 ) {
+        return;
+    }
+    dx[0] = dy[0] = 0.0f;
+    dx[width-1] = dy[width-1] = 0.0f;
+
+    int x = 1;
+    __m128 s = _mm_set1_ps(scale);
+    for(; x+4<width; x+=4) {
+        __m128i gx = _mm_sub_epi32(load4(current+x+1), load4(current+x-1));
+        __m128i gy = _mm_sub_epi32(load4(next+x), load4(previous+x));
+        _mm_storeu_ps(dx+x, _mm_mul_ps(_mm_cvtepi32_ps(gx), s));
+        _mm_storeu_ps(dy+x, _mm_mul_ps(_mm_cvtepi32_ps(gy), s));
+    }
+    for(; x<width-1; x++) {
+        dx[x] = (float)((int)current[x+1] - (int)current[x-1]) * scale;
+        dy[x] = (float)((int)next[x] - (int)previous[x]) * scale;
+    }
+}
+
+static void steepestRowFloat(const float* jx, const float* jy, const float* dx, const float* dy, int width, float* out) {
+    int x = 0;
+    for(; x+4<=width; x+=4) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(jx+x), _mm_loadu_ps(dx+x));
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(jy+x), _mm_loadu_ps(dy+x));
+        _mm_storeu_ps(out+x, _mm_add_ps(a, b));
+    }
+    for(; x<width; x++) {
+        out[x] = jx[x] * dx[x] + jy[x] * dy[x];
+    }
+}
+
+static void errorRowFloat(const float* sampled, const unsigned char* reference, int width, float scale, float* error) {
+    int x = 0;
+    __m128 s = _mm_set1_ps(scale);
+    for(; x+4<=width; x+=4) {
+        __m128 r = _mm_cvtepi32_ps(load4(reference+x));
+        _mm_storeu_ps(error+x, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(sampled+x), r), s));
+    }
+    for(; x<width; x++) {
+        error[x] = (sampled[x] - (float)reference[x]) * scale;
+    }
+}
+
+static double dotFloat(const float* a, const float* b, int width) {
+    float lanes[8];
+    int x = 0;
+    __m128 low = _mm_setzero_ps(), high = _mm_setzero_ps();
+    for(; x+8<=width; x+=8) {
+        low  = _mm_add_ps(low,  _mm_mul_ps(_mm_loadu_ps(a+x),   _mm_loadu_ps(b+x)));
+        high = _mm_add_ps(high, _mm_mul_ps(_mm_loadu_ps(a+x+4), _mm_loadu_ps(b+x+4)));
+    }
+    _mm_storeu_ps(lanes, low);
+    _mm_storeu_ps(lanes+4, high);
+    for(; x<width; x++) {
+        lanes[x&7] += a[x] * b[x];
+    }
+    return (((double)lanes[0] + lanes[4]) + ((double)lanes[2] + lanes[6])) + (((double)lanes[1] + lanes[5]) + ((double)lanes[3] + lanes[7]));
+}
+
+static void tileDot(const double* tiles, const double* error, int count, int params, double* lanes) {
+    for(int t=0; t<count; t++) {
+        const double* e = error + t*8;
+        __m128d e0 = _mm_loadu_pd(e), e1 = _mm_loadu_pd(e+2), e2 = _mm_loadu_pd(e+4), e3 = _mm_loadu_pd(e+6);
+        for(int p=0; p<params; p++) {
+            const double* tile = tiles + (t*params + p)*8;
+            double* l = lanes + p*8;
+            _mm_storeu_pd(l,   _mm_add_pd(_mm_loadu_pd(l),   _mm_mul_pd(_mm_loadu_pd(tile),   e0)));
+            _mm_storeu_pd(l+2, _mm_add_pd(_mm_loadu_pd(l+2), _mm_mul_pd(_mm_loadu_pd(tile+2), e1)));
+            _mm_storeu_pd(l+4, _mm_add_pd(_mm_loadu_pd(l+4), _mm_mul_pd(_mm_loadu_pd(tile+4), e2)));
+            _mm_storeu_pd(l+6, _mm_add_pd(_mm_loadu_pd(l+6), _mm_mul_pd(_mm_loadu_pd(tile+6), e3)));
+        }
+    }
+}
+
+static void tileDotFloat(const float* tiles, const float* error, int count, int params, float* lanes) {
+    for(int t=0; t<count; t++) {
+        const float* e = error + t*8;
+        __m128 low = _mm_loadu_ps(e), high = _mm_loadu_ps(e+4);
+        for(int p=0; p<params; p++) {
+            const float* tile = tiles + (t*params + p)*8;
+            float* l = lanes + p*8;
+            _mm_storeu_ps(l,   _mm_add_ps(_mm_loadu_ps(l),   _mm_mul_ps(_mm_loadu_ps(tile),   low)));
+            _mm_storeu_ps(l+4, _mm_add_ps(_mm_loadu_ps(l+4), _mm_mul_ps(_mm_loadu_ps(tile+4), high)));
+        }
+    }
+}
+
+const Kernels::Table Kernels::SSE42 = {
+    "sse4.2", ::gradientRow, ::steepestRow, ::errorRow, ::dot, ::tileDot,
+    ::gradientRowFloat, ::steepestRowFloat, ::errorRowFloat, ::dotFloat, ::tileDotFloat
+};
+#else
+const Kernels::Table Kernels::SSE42 = {
+    "sse4.2", NULL, NULL, NULL, NULL, NULL,
+    NULL, NULL, NULL, NULL, NULL
+};
+#endif
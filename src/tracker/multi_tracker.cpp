@@ -0,0 +1,49 @@
+#include "tracker/multi_tracker.hpp"
+
+#include "exceptions/invalid_parameters.hpp"
+
+using namespace Stick;
+
+// the frame is shared read only, every task writes only its own tracker and pose
+MultiTracker::MultiTracker(int threads) : pool(threads), frame(NULL), scale(1.0) {
+    this->trackTask = [this](int i) {
+        this->trackers[i]->track(*this->frame, this->scale);
+        this->poses[i] = this->trackers[i]->getModel()->getMatx();
+    };
+}
+
+MultiTracker::~MultiTracker() {
+    for(Tracker* tracker : this->trackers) {
+        delete tracker;
+    }
+    this->trackers.clear();
+}
+
+int MultiTracker::add(Tracker* tracker) {
+    if( tracker == NULL ) {
+        throw MakeClassException(InvalidParameters, "tracker is null");
+    }
+    this->trackers.push_back(tracker);
+    this->poses.push_back(tracker->getModel()->getMatx());
+    return (int)this->trackers.size() - 1;
+}
+
+Tracker* MultiTracker::get(int index) const {
+    if( index < 0 || index >= (int)this->trackers.size() ) {
+        throw MakeClassException(InvalidParameters, instant::Utils::String::Format("tracker index out of range (input:%d, size:%d)", index, (int)this->trackers.size()));
+    }
+    return this->trackers[index];
+}
+
+void MultiTracker::initialize() {
+    this->pool.run(this->trackers.size(), [this](int i) {
+        this->trackers[i]->initialize();
+        this->poses[i] = this->trackers[i]->getModel()->getMatx();
+    });
+}
+
+void MultiTracker::track(const cv::Mat& image, const double scale) {
+    this->frame = &image;
+    this->scale = scale;
+    this->pool.run(this->trackers.size(), this->trackTask);
+}
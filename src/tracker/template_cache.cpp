@@ -0,0 +1,210 @@
+#include "tracker/template_cache.hpp"
+
+#include "exceptions/invalid_parameters.hpp"
+#include "io/binary_file.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace Stick;
+
+const uint32_t TemplateCache::Version;
+
+static const char Magic[8] = {'S', 'T', 'I', 'C', 'K', 'T', 'P', 'L'};
+static const uint32_t ByteOrder = 0x01020304;
+
+static const uint64_t FnvOffset = 14695981039346656037ULL;
+static const uint64_t FnvPrime = 1099511628211ULL;
+
+static uint64_t fnv(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i=0; i<size; i++) {
+        hash = (hash ^ bytes[i]) * FnvPrime;
+    }
+    return hash;
+}
+
+static void putMat(BinaryWriter& writer, const cv::Mat& mat) {
+    writer.put<int32_t>(mat.rows);
+    writer.put<int32_t>(mat.cols);
+    writer.put<int32_t>(mat.type());
+    writer.align();
+    for(int r=0; r<mat.rows; r++) {
+        writer.append(mat.ptr(r), mat.cols * mat.elemSize());
+    }
+}
+
+template<typename V>
+static void putVector(BinaryWriter& writer, const std::vector<V>& values) {
+    writer.put<uint64_t>(values.size());
+    if( !values.empty() ) {
+        writer.append(&values[0], values.size() * sizeof(V));
+    }
+}
+
+// a header on the mapped bytes, nothing is copied
+static cv::Mat getMat(BinaryReader& reader) {
+    int rows = reader.get<int32_t>();
+    int cols = reader.get<int32_t>();
+    int type = reader.get<int32_t>();
+    if( rows < 0 || cols < 0 || CV_MAT_DEPTH(type) > CV_64F ) {
+        throw MakeException(InvalidParameters, "TemplateCache", "malformed matrix in template cache");
+    }
+    reader.align();
+    const char* data = reader.take((size_t)rows * cols * CV_ELEM_SIZE(type));
+    if( rows == 0 || cols == 0 ) {
+        return cv::Mat();
+    }
+    return cv::Mat(rows, cols, type, (void*)data);
+}
+
+template<typename V>
+static void getVector(BinaryReader& reader, std::vector<V>& values) {
+    uint64_t count = reader.get<uint64_t>();
+    if( count > reader.getRemaining() / sizeof(V) ) {
+        throw MakeException(InvalidParameters, "TemplateCache", "truncated template cache");
+    }
+    const char* data = reader.take(count * sizeof(V));
+    values.resize(count);
+    if( count > 0 ) {
+        memcpy(&values[0], data, count * sizeof(V));
+    }
+}
+
+// every matrix has the size the template, the tracked pixels and the parameters give it, so reading
+// the level in track() stays inside its buffers. gradients and jacobians may be left out
+static void checkLevel(const TrackingLevel& level, int params, int depth) {
+    const cv::Mat& image = level.templateImage;
+    if( !(level.scale > 0.0) || image.empty() || image.type() != CV_8UC1 ) {
+        throw MakeException(InvalidParameters, "TemplateCache", "malformed template image in template cache");
+    }
+    int area = image.size().area();
+    for(size_t i=0; i<level.pixels.size(); i++) {
+        if( level.pixels[i] < 0 || level.pixels[i] >= area || (i > 0 && level.pixels[i] <= level.pixels[i-1]) ) {
+            throw MakeException(InvalidParameters, "TemplateCache", instant::Utils::String::Format("pixel out of the template in template cache (input:%d, size:%d)", level.pixels[i], area));
+        }
+    }
+    if( level.reference.size() != level.pixels.size() ) {
+        throw MakeException(InvalidParameters, "TemplateCache", "reference values do not match the pixels in template cache");
+    }
+
+    int count = level.getCount();
+    int rows = (count + image.cols - 1) / image.cols;
+    int type = CV_MAKETYPE(depth, 1);
+    const cv::Mat& steepest = level.steepest;
+    const cv::Mat& hessianInv = level.hessianInv;
+    const cv::Mat& gradients = level.gradients;
+    const cv::Mat& jacobians = level.jacobians;
+    if( steepest.type() != type || steepest.cols != params*Kernels::TileSize || steepest.rows != rows*level.getTilesPerRow() ||
+        hessianInv.type() != CV_64FC1 || hessianInv.rows != params || hessianInv.cols != params ||
+        (!gradients.empty() && (gradients.type() != type || gradients.rows != 2 || gradients.cols != area)) ||
+        (!jacobians.empty() && (jacobians.type() != type || jacobians.rows != 2*params || jacobians.cols != count)) ) {
+        throw MakeException(InvalidParameters, "TemplateCache", "matrix size does not match the template in template cache");
+    }
+}
+
+namespace {
+    // the mapping the matrices of loaded template data point into, held as its owner
+    struct Mapping {
+        Mapping(void* address, size_t length) : address(address), length(length) {
+        }
+        ~Mapping() {
+            munmap(this->address, this->length);
+        }
+
+        void* address;
+        size_t length;
+    };
+}
+
+uint64_t TemplateCache::Hash(const cv::Mat& image, const std::string& configuration) {
+    int32_t size[3] = {image.rows, image.cols, image.type()};
+    uint64_t hash = fnv(FnvOffset, size, sizeof(size));
+    for(int r=0; r<image.rows; r++) {
+        hash = fnv(hash, image.ptr(r), image.cols * image.elemSize());
+    }
+    return fnv(hash, configuration.data(), configuration.size());
+}
+
+void TemplateCache::Save(const std::string& path, const TemplateData& templateData, uint64_t key) {
+    BinaryWriter writer(path, "TemplateCache", "template cache");
+    writer.append(Magic, sizeof(Magic));
+    writer.put<uint32_t>(Version);
+    writer.put<uint32_t>(ByteOrder);
+    writer.put<uint64_t>(key);
+    writer.put<int32_t>(templateData.depth);
+    writer.put<int32_t>(templateData.parameterSize);
+    writer.put<double>(templateData.pixelFraction);
+    putVector(writer, std::vector<char>(templateData.modelName.begin(), templateData.modelName.end()));
+    writer.put<uint32_t>(templateData.levels.size());
+    for(const TrackingLevel& level : templateData.levels) {
+        writer.put<double>(level.scale);
+        putMat(writer, level.templateImage);
+        putMat(writer, level.gradients);
+        putMat(writer, level.hessianInv);
+        putMat(writer, level.steepest);
+        putMat(writer, level.jacobians);
+        putVector(writer, level.pixels);
+        putVector(writer, level.reference);
+    }
+
+    writer.commit();
+}
+
+std::shared_ptr<const TemplateData> TemplateCache::Load(const std::string& path, uint64_t key) {
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if( descriptor < 0 ) {
+        return std::shared_ptr<const TemplateData>();
+    }
+    struct stat status;
+    if( fstat(descriptor, &status) != 0 || status.st_size == 0 ) {
+        close(descriptor);
+        return std::shared_ptr<const TemplateData>();
+    }
+    size_t length = status.st_size;
+    void* address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if( address == MAP_FAILED ) {
+        return std::shared_ptr<const TemplateData>();
+    }
+    // unmapped with the data and every copy of it, also when reading throws
+    std::shared_ptr<const void> mapping(new Mapping(address, length));
+    std::shared_ptr<TemplateData> templateData = std::make_shared<TemplateData>();
+    templateData->owner = mapping;
+
+    BinaryReader reader((const char*)address, length, 0, "TemplateCache", "template cache");
+    if( length < sizeof(Magic) || memcmp(reader.take(sizeof(Magic)), Magic, sizeof(Magic)) != 0 ) {
+        throw MakeException(InvalidParameters, "TemplateCache", instant::Utils::String::Format("not a template cache (path:%s)", path.c_str()));
+    }
+    if( reader.get<uint32_t>() != Version || reader.get<uint32_t>() != ByteOrder || reader.get<uint64_t>() != key ) {
+        return std::shared_ptr<const TemplateData>();
+    }
+
+    templateData->depth = reader.get<int32_t>();
+    templateData->parameterSize = reader.get<int32_t>();
+    templateData->pixelFraction = reader.get<double>();
+    if( (templateData->depth != CV_32F && templateData->depth != CV_64F) || templateData->parameterSize <= 0 ) {
+        throw MakeException(InvalidParameters, "TemplateCache", "malformed header in template cache");
+    }
+    std::vector<char> modelName;
+    getVector(reader, modelName);
+    templateData->modelName.assign(modelName.begin(), modelName.end());
+    uint32_t levelCount = reader.get<uint32_t>();
+    for(uint32_t l=0; l<levelCount; l++) {
+        TrackingLevel level;
+        level.scale = reader.get<double>();
+        level.templateImage = getMat(reader);
+        level.gradients = getMat(reader);
+        level.hessianInv = getMat(reader);
+        level.steepest = getMat(reader);
+        level.jacobians = getMat(reader);
+        getVector(reader, level.pixels);
+        getVector(reader, level.reference);
+        checkLevel(level, templateData->parameterSize, templateData->depth);
+        templateData->levels.push_back(level);
+    }
+    return templateData;
+}
@@ -0,0 +1,78 @@
+#include <cstdlib>
+#include <cerrno>
+#include <new>
+#include <atomic>
+
+#include "allocation.hpp"
+
+static std::atomic<bool> counting(false);
+static std::atomic<int> allocations(0);
+
+static inline void count() {
+    if( counting.load(std::memory_order_relaxed) ) {
+        allocations++;
+    }
+}
+
+void Allocation::start() {
+    allocations = 0;
+    counting = true;
+}
+
+int Allocation::stop() {
+    counting = false;
+    return allocations;
+}
+
+// sanitizers interpose malloc themselves
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* p, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    // the executable's definitions take the place of the libc ones for every library, opencv included
+    void* malloc(size_t size) {
+        count();
+        return __libc_malloc(size);
+    }
+    void* calloc(size_t number, size_t size) {
+        count();
+        return __libc_calloc(number, size);
+    }
+    void* realloc(void* p, size_t size) {
+        count();
+        return __libc_realloc(p, size);
+    }
+    void* memalign(size_t alignment, size_t size) {
+        count();
+        return __libc_memalign(alignment, size);
+    }
+    int posix_memalign(void** p, size_t alignment, size_t size) {
+        if( alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 ) {
+            return EINVAL;
+        }
+        count();
+        *p = __libc_memalign(alignment, size);
+        return *p == NULL && size > 0 ? ENOMEM : 0;
+    }
+    void* aligned_alloc(size_t alignment, size_t size) {
+        count();
+        return __libc_memalign(alignment, size);
+    }
+}
+#else
+void* operator new(std::size_t size) {
+    count();
+    void* p = std::malloc(size ? size : 1);
+    if( p == NULL ) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef __TEST_ALLOCATION_HPP__
+#define __TEST_ALLOCATION_HPP__
+
+// counts heap allocations between start() and stop(). with glibc every malloc is counted, which covers
+// operator new as well as the cv::Mat buffers taken through cv::fastMalloc. elsewhere only operator new is
+namespace Allocation {
+    void start();
+    int stop();
+}
+
+#endif //__TEST_ALLOCATION_HPP__
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <io/binary_file.hpp>
+#include <exceptions/invalid_parameters.hpp>
+
+static const char* BinaryPath = "binary_file_test.bin";
+
+static std::vector<char> readFile(const char* path) {
+    std::vector<char> bytes;
+    FILE* file = fopen(path, "rb");
+    if( file == NULL ) {
+        return bytes;
+    }
+    char buffer[256];
+    size_t read;
+    while( (read = fread(buffer, 1, sizeof(buffer), file)) > 0 ) {
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    }
+    fclose(file);
+    return bytes;
+}
+
+TEST(BinaryFile, write_read) {
+    remove(BinaryPath);
+    {
+        Stick::BinaryWriter writer(BinaryPath, "BinaryFileTest", "test file");
+        writer.put<uint32_t>(0);
+        writer.put<uint8_t>(7);
+        writer.align();
+        EXPECT_EQ(Stick::BinaryWriter::Alignment, writer.getOffset());
+        writer.put<double>(2.5);
+        uint32_t count = 42;
+        writer.patch(0, &count, sizeof(count));
+        EXPECT_THROW(writer.patch(writer.getOffset(), &count, sizeof(count)), Stick::InvalidParameters);
+
+        // nothing is visible before commit
+        EXPECT_TRUE(readFile(BinaryPath).empty());
+        writer.commit();
+        EXPECT_THROW(writer.put<uint8_t>(1), Stick::InvalidParameters);
+    }
+
+    std::vector<char> bytes = readFile(BinaryPath);
+    ASSERT_EQ(Stick::BinaryWriter::Alignment + sizeof(double), bytes.size());
+    Stick::BinaryReader reader(&bytes[0], bytes.size(), 0, "BinaryFileTest", "test file");
+    EXPECT_EQ(42u, reader.get<uint32_t>());
+    EXPECT_EQ(7, reader.get<uint8_t>());
+    reader.align();
+    EXPECT_EQ(2.5, reader.get<double>());
+    EXPECT_EQ(0u, reader.getRemaining());
+    EXPECT_THROW(reader.get<uint8_t>(), Stick::InvalidParameters);
+
+    // an offset past the end is truncated as well
+    Stick::BinaryReader outside(&bytes[0], bytes.size(), bytes.size() + 8, "BinaryFileTest", "test file");
+    EXPECT_EQ(0u, outside.getRemaining());
+    EXPECT_THROW(outside.take(0), Stick::InvalidParameters);
+    remove(BinaryPath);
+}
+
+TEST(BinaryFile, uncommitted) {
+    remove(BinaryPath);
+    {
+        Stick::BinaryWriter writer(BinaryPath, "BinaryFileTest", "test file");
+        writer.put<uint64_t>(1);
+    }
+    EXPECT_TRUE(readFile(BinaryPath).empty());
+    EXPECT_THROW(Stick::BinaryWriter("no/such/directory/file.bin", "BinaryFileTest", "test file"), Stick::InvalidParameters);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <io/packed_sequence.hpp>
+#include <exceptions/invalid_parameters.hpp>
+
+static const char* SequencePath = "packed_sequence_test.seq";
+
+static bool equals(const cv::Mat& a, const cv::Mat& b) {
+    if( a.rows != b.rows || a.cols != b.cols || a.type() != b.type() ) {
+        return false;
+    }
+    for(int r=0; r<a.rows; r++) {
+        if( memcmp(a.ptr(r), b.ptr(r), a.cols * a.elemSize()) != 0 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(PackedSequence, write_read) {
+    cv::Mat first = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat second = cv::imread("datas/im001.png", CV_LOAD_IMAGE_GRAYSCALE);
+    // a roi is packed without its parent's row padding, with an odd width the next frame has to be realigned
+    cv::Mat cropped = second(cv::Rect(3, 5, 61, 47));
+
+    remove(SequencePath);
+    {
+        Stick::PackedSequenceWriter writer(SequencePath, 25.0);
+        writer.append(first, "im000.png");
+        writer.append(cropped, "cropped");
+        writer.append(second, "im001.png");
+        EXPECT_EQ(3, (int)writer.getFrameCount());
+        EXPECT_THROW(writer.append(cv::Mat(4, 4, CV_32FC1), "float"), Stick::InvalidParameters);
+
+        // nothing is visible before close
+        EXPECT_FALSE(Stick::PackedSequence::IsPackedSequence(SequencePath));
+        writer.close();
+    }
+    EXPECT_TRUE(Stick::PackedSequence::IsPackedSequence(SequencePath));
+    EXPECT_FALSE(Stick::PackedSequence::IsPackedSequence("datas/im000.png"));
+
+    Stick::PackedSequence sequence(SequencePath);
+    ASSERT_EQ(3, (int)sequence.getFrameCount());
+    EXPECT_EQ(25.0, sequence.getRate());
+    EXPECT_EQ("im000.png", sequence.getFrameName(0));
+    EXPECT_EQ("cropped", sequence.getFrameName(1));
+    EXPECT_EQ("im001.png", sequence.getFrameName(2));
+    EXPECT_TRUE(equals(first, sequence.getFrame(0)));
+    EXPECT_TRUE(equals(cropped, sequence.getFrame(1)));
+    EXPECT_TRUE(equals(second, sequence.getFrame(2)));
+    for(int f=0; f<3; f++) {
+        EXPECT_EQ(0u, (uintptr_t)sequence.getFrame(f).data % 64);
+    }
+    // views on the mapping, no copies
+    EXPECT_EQ(sequence.getFrame(1).data, sequence.getFrame(1).data);
+    EXPECT_THROW(sequence.getFrame(3), Stick::InvalidParameters);
+    EXPECT_THROW(sequence.getFrameName(3), Stick::InvalidParameters);
+    remove(SequencePath);
+}
+
+TEST(PackedSequence, malformed) {
+    EXPECT_THROW(Stick::PackedSequence sequence("packed_sequence_missing.seq"), Stick::InvalidParameters);
+    EXPECT_THROW(Stick::PackedSequence sequence("datas/im000.png"), Stick::InvalidParameters);
+
+    remove(SequencePath);
+    {
+        Stick::PackedSequenceWriter writer(SequencePath);
+        writer.append(cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE), "im000.png");
+        // dropped without close, the temporary file is removed
+    }
+    EXPECT_FALSE(Stick::PackedSequence::IsPackedSequence(SequencePath));
+
+    {
+        Stick::PackedSequenceWriter writer(SequencePath);
+        writer.append(cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE), "im000.png");
+        writer.close();
+    }
+    {
+        Stick::PackedSequence sequence(SequencePath);
+        EXPECT_EQ(0.0, sequence.getRate());
+        EXPECT_EQ(1, (int)sequence.getFrameCount());
+    }
+    // the index sits at the end, a cut off file is detected
+    FILE* file = fopen(SequencePath, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    ASSERT_EQ(0, truncate(SequencePath, size - 4));
+    EXPECT_THROW(Stick::PackedSequence sequence(SequencePath), Stick::InvalidParameters);
+    remove(SequencePath);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <model/affine.hpp>
+
+TEST(Affine, create) {
+    Stick::Affine model;
+    EXPECT_EQ(6, model.getParameterSize());
+}
+
+TEST(Affine, set_get_initialize) {
+    Stick::Affine model;
+
+    cv::Mat pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+
+    pose.at<double>(cv::Point(1, 0)) = 0.5;
+    pose.at<double>(cv::Point(2, 0)) = 2.0;
+    pose.at<double>(cv::Point(2, 1)) = 3.0;
+    model.set(pose);
+
+    pose = model.get();
+    EXPECT_EQ(0.5, pose.at<double>(cv::Point(1, 0)));
+    EXPECT_EQ(2.0, pose.at<double>(cv::Point(2, 0)));
+    EXPECT_EQ(3.0, pose.at<double>(cv::Point(2, 1)));
+
+    model.initialize();
+    pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+}
+
+TEST(Affine, compose) {
+    Stick::Affine model;
+
+    cv::Mat pose = model.get();
+    pose.at<double>(0, 0) = 1;
+    pose.at<double>(0, 1) = 2;
+    pose.at<double>(0, 2) = 3;
+    pose.at<double>(1, 0) = 4;
+    pose.at<double>(1, 1) = 5;
+    pose.at<double>(1, 2) = 6;
+
+    model.compose( pose );
+    cv::Point pt = model.transform(cv::Point(3, 4));
+    EXPECT_EQ(14, pt.x);
+    EXPECT_EQ(38, pt.y);
+
+    model.compose( pose );
+    pt = model.transform(cv::Point(3, 4));
+    EXPECT_EQ(1*14+2*38+3, pt.x);
+    EXPECT_EQ(4*14+5*38+6, pt.y);
+}
+
+TEST(Affine, inverse) {
+    Stick::Affine model;
+
+    cv::Mat pose = model.get();
+    pose.at<double>(0, 0) = 1;
+    pose.at<double>(0, 1) = 2;
+    pose.at<double>(0, 2) = 3;
+    pose.at<double>(1, 0) = 4;
+    pose.at<double>(1, 1) = 5;
+    pose.at<double>(1, 2) = 6;
+
+    model.compose( pose );
+    model.set( model.inverse() );
+    cv::Point pt = model.transform(cv::Point(14, 38));
+    EXPECT_EQ(3, pt.x);
+    EXPECT_EQ(4, pt.y);
+}
+
+TEST(Affine, jacobian) {
+    Stick::Affine model;
+
+    cv::Mat jacobian = model.jacobian(cv::Point(3, 4));
+    EXPECT_EQ(cv::Size(6, 2), jacobian.size());
+    EXPECT_EQ(3, jacobian.at<double>(0, 0));
+    EXPECT_EQ(4, jacobian.at<double>(0, 1));
+    EXPECT_EQ(1, jacobian.at<double>(0, 2));
+    EXPECT_EQ(0, jacobian.at<double>(0, 3));
+    EXPECT_EQ(0, jacobian.at<double>(0, 4));
+    EXPECT_EQ(0, jacobian.at<double>(0, 5));
+    EXPECT_EQ(0, jacobian.at<double>(1, 0));
+    EXPECT_EQ(0, jacobian.at<double>(1, 1));
+    EXPECT_EQ(0, jacobian.at<double>(1, 2));
+    EXPECT_EQ(3, jacobian.at<double>(1, 3));
+    EXPECT_EQ(4, jacobian.at<double>(1, 4));
+    EXPECT_EQ(1, jacobian.at<double>(1, 5));
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <model/euclidean.hpp>
+
+static cv::Mat parameters(double tx, double ty, double theta) {
+    cv::Mat out = cv::Mat::zeros(cv::Size(1, 3), cv::DataType<double>::type);
+    out.at<double>(0) = tx;
+    out.at<double>(1) = ty;
+    out.at<double>(2) = theta;
+    return out;
+}
+
+TEST(Euclidean, create) {
+    Stick::Euclidean model;
+    EXPECT_EQ(3, model.getParameterSize());
+}
+
+TEST(Euclidean, set_get_initialize) {
+    Stick::Euclidean model;
+
+    cv::Mat pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+
+    model.set(model.toPose(parameters(2.0, 3.0, 0.0)));
+    pose = model.get();
+    EXPECT_EQ(2.0, pose.at<double>(cv::Point(2, 0)));
+    EXPECT_EQ(3.0, pose.at<double>(cv::Point(2, 1)));
+
+    model.initialize();
+    pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+}
+
+TEST(Euclidean, transform) {
+    Stick::Euclidean model;
+
+    model.set(model.toPose(parameters(20.0, 3.0, CV_PI/2.0)));
+    cv::Point pt = model.transform(cv::Point(2, 3));
+    EXPECT_EQ(17, pt.x);
+    EXPECT_EQ(5, pt.y);
+}
+
+TEST(Euclidean, compose) {
+    Stick::Euclidean model;
+
+    model.compose(model.toPose(parameters(0.0, 0.0, CV_PI/4.0)));
+    model.compose(model.toPose(parameters(1.0, 0.0, CV_PI/4.0)));
+
+    cv::Mat pose = model.get();
+    EXPECT_NEAR(0.0, pose.at<double>(0, 0), 1e-12);
+    EXPECT_NEAR(1.0, pose.at<double>(1, 0), 1e-12);
+    EXPECT_NEAR(std::sqrt(0.5), pose.at<double>(0, 2), 1e-12);
+    EXPECT_NEAR(std::sqrt(0.5), pose.at<double>(1, 2), 1e-12);
+}
+
+TEST(Euclidean, inverse) {
+    Stick::Euclidean model;
+
+    model.compose(model.toPose(parameters(2.0, 3.0, 0.3)));
+    cv::Point pt = model.transform(cv::Point(30, 40));
+    model.set( model.inverse() );
+
+    pt = model.transform(pt);
+    EXPECT_EQ(30, pt.x);
+    EXPECT_EQ(40, pt.y);
+}
+
+TEST(Euclidean, jacobian) {
+    Stick::Euclidean model;
+
+    cv::Mat jacobian = model.jacobian(cv::Point(3, 4));
+    EXPECT_EQ(cv::Size(3, 2), jacobian.size());
+    EXPECT_EQ(1, jacobian.at<double>(0, 0));
+    EXPECT_EQ(0, jacobian.at<double>(0, 1));
+    EXPECT_EQ(-4, jacobian.at<double>(0, 2));
+    EXPECT_EQ(0, jacobian.at<double>(1, 0));
+    EXPECT_EQ(1, jacobian.at<double>(1, 1));
+    EXPECT_EQ(3, jacobian.at<double>(1, 2));
+}
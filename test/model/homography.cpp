@@ -228,3 +228,45 @@ TEST(Homography, jacobian) {
     EXPECT_EQ(0, jacobian.at<double>(1, 8));
 }
 
+
+TEST(Homography, jacobian_row) {
+    Stick::Homography model;
+
+    cv::Mat pose = model.get();
+    pose.at<double>(0, 1) = 0.1;
+    pose.at<double>(1, 2) = 3.0;
+    pose.at<double>(2, 0) = 0.001;
+    model.set(pose);
+
+    int width = 5;
+    std::vector<double> out(2*model.getParameterSize()*width);
+    model.jacobianRow(-2.5, 4.0, width, &out[0]);
+    for(int i=0; i<width; i++) {
+        cv::Mat in = cv::Mat::ones(cv::Size(1, 3), cv::DataType<double>::type);
+        in.at<double>(0) = -2.5 + i;
+        in.at<double>(1) = 4.0;
+        cv::Mat jacobian = model.jacobian(in);
+        for(int p=0; p<model.getParameterSize(); p++) {
+            EXPECT_DOUBLE_EQ(jacobian.at<double>(0, p), out[(2*p)*width + i]);
+            EXPECT_DOUBLE_EQ(jacobian.at<double>(1, p), out[(2*p+1)*width + i]);
+        }
+    }
+}
+
+TEST(Homography, copy) {
+    Stick::Homography model;
+
+    cv::Mat pose = model.get();
+    pose.at<double>(0, 2) = 2.0;
+    model.set(pose);
+
+    Stick::Homography copied(model);
+    EXPECT_EQ(2.0, copied.getMatx()(0, 2));
+
+    model.initialize();
+    EXPECT_EQ(0.0, model.get().at<double>(0, 2));
+    EXPECT_EQ(2.0, copied.get().at<double>(0, 2));
+
+    copied = model;
+    EXPECT_EQ(0.0, copied.get().at<double>(0, 2));
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <model/similarity.hpp>
+
+static cv::Mat parameters(double a, double b, double tx, double ty) {
+    cv::Mat out = cv::Mat::zeros(cv::Size(1, 4), cv::DataType<double>::type);
+    out.at<double>(0) = a;
+    out.at<double>(1) = b;
+    out.at<double>(2) = tx;
+    out.at<double>(3) = ty;
+    return out;
+}
+
+TEST(Similarity, create) {
+    Stick::Similarity model;
+    EXPECT_EQ(4, model.getParameterSize());
+}
+
+TEST(Similarity, set_get_initialize) {
+    Stick::Similarity model;
+
+    cv::Mat pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+
+    model.set(model.toPose(parameters(1.0, 0.5, 2.0, 3.0)));
+    pose = model.get();
+    EXPECT_EQ(2.0, pose.at<double>(0, 0));
+    EXPECT_EQ(-0.5, pose.at<double>(0, 1));
+    EXPECT_EQ(2.0, pose.at<double>(0, 2));
+    EXPECT_EQ(0.5, pose.at<double>(1, 0));
+    EXPECT_EQ(2.0, pose.at<double>(1, 1));
+    EXPECT_EQ(3.0, pose.at<double>(1, 2));
+
+    model.initialize();
+    pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+}
+
+TEST(Similarity, transform) {
+    Stick::Similarity model;
+
+    model.set(model.toPose(parameters(1.0, 0.0, 2.0, 3.0)));
+    cv::Point pt = model.transform(cv::Point(2, 3));
+    EXPECT_EQ(6, pt.x);
+    EXPECT_EQ(9, pt.y);
+}
+
+TEST(Similarity, compose) {
+    Stick::Similarity model;
+
+    model.compose(model.toPose(parameters(1.0, 0.0, 2.0, 3.0)));
+    model.compose(model.toPose(parameters(1.0, 0.0, 2.0, 3.0)));
+    cv::Point pt = model.transform(cv::Point(3, 4));
+    EXPECT_EQ(2*(2*3+2)+2, pt.x);
+    EXPECT_EQ(2*(2*4+3)+3, pt.y);
+}
+
+TEST(Similarity, inverse) {
+    Stick::Similarity model;
+
+    model.compose(model.toPose(parameters(0.2, 0.3, 2.0, 3.0)));
+    cv::Point pt = model.transform(cv::Point(30, 40));
+    model.set( model.inverse() );
+
+    pt = model.transform(pt);
+    EXPECT_EQ(30, pt.x);
+    EXPECT_EQ(40, pt.y);
+}
+
+TEST(Similarity, jacobian) {
+    Stick::Similarity model;
+
+    cv::Mat jacobian = model.jacobian(cv::Point(3, 4));
+    EXPECT_EQ(cv::Size(4, 2), jacobian.size());
+    EXPECT_EQ(3, jacobian.at<double>(0, 0));
+    EXPECT_EQ(-4, jacobian.at<double>(0, 1));
+    EXPECT_EQ(1, jacobian.at<double>(0, 2));
+    EXPECT_EQ(0, jacobian.at<double>(0, 3));
+    EXPECT_EQ(4, jacobian.at<double>(1, 0));
+    EXPECT_EQ(3, jacobian.at<double>(1, 1));
+    EXPECT_EQ(0, jacobian.at<double>(1, 2));
+    EXPECT_EQ(1, jacobian.at<double>(1, 3));
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <model/translation.hpp>
+
+TEST(Translation, create) {
+    Stick::Translation model;
+    EXPECT_EQ(2, model.getParameterSize());
+}
+
+TEST(Translation, set_get_initialize) {
+    Stick::Translation model;
+
+    cv::Mat pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+
+    pose.at<double>(cv::Point(2, 0)) = 2.0;
+    pose.at<double>(cv::Point(2, 1)) = 3.0;
+    model.set(pose);
+
+    pose = model.get();
+    EXPECT_EQ(2.0, pose.at<double>(cv::Point(2, 0)));
+    EXPECT_EQ(3.0, pose.at<double>(cv::Point(2, 1)));
+
+    model.initialize();
+    pose = model.get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+}
+
+TEST(Translation, transform) {
+    Stick::Translation model;
+
+    cv::Point pt = model.transform(cv::Point(2, 3));
+    EXPECT_EQ(2, pt.x);
+    EXPECT_EQ(3, pt.y);
+
+    cv::Mat parameters = cv::Mat::zeros(cv::Size(1, 2), cv::DataType<double>::type);
+    parameters.at<double>(0) = 2.0;
+    parameters.at<double>(1) = 3.0;
+    model.set(model.toPose(parameters));
+
+    pt = model.transform(cv::Point(2, 3));
+    EXPECT_EQ(4, pt.x);
+    EXPECT_EQ(6, pt.y);
+}
+
+TEST(Translation, compose) {
+    Stick::Translation model;
+
+    cv::Mat parameters = cv::Mat::zeros(cv::Size(1, 2), cv::DataType<double>::type);
+    parameters.at<double>(0) = 2.0;
+    parameters.at<double>(1) = 3.0;
+    model.compose(model.toPose(parameters));
+    model.compose(model.toPose(parameters));
+
+    cv::Point pt = model.transform(cv::Point(3, 4));
+    EXPECT_EQ(7, pt.x);
+    EXPECT_EQ(10, pt.y);
+}
+
+TEST(Translation, inverse) {
+    Stick::Translation model;
+
+    cv::Mat parameters = cv::Mat::zeros(cv::Size(1, 2), cv::DataType<double>::type);
+    parameters.at<double>(0) = 2.0;
+    parameters.at<double>(1) = 3.0;
+    model.compose(model.toPose(parameters));
+    model.set( model.inverse() );
+
+    cv::Point pt = model.transform(cv::Point(5, 7));
+    EXPECT_EQ(3, pt.x);
+    EXPECT_EQ(4, pt.y);
+}
+
+TEST(Translation, jacobian) {
+    Stick::Translation model;
+
+    cv::Mat jacobian = model.jacobian(cv::Point(3, 4));
+    EXPECT_EQ(cv::Size(2, 2), jacobian.size());
+    EXPECT_EQ(1, jacobian.at<double>(0, 0));
+    EXPECT_EQ(0, jacobian.at<double>(0, 1));
+    EXPECT_EQ(0, jacobian.at<double>(1, 0));
+    EXPECT_EQ(1, jacobian.at<double>(1, 1));
+}
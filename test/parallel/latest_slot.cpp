@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <parallel/latest_slot.hpp>
+
+TEST(LatestSlot, put_take) {
+    Stick::LatestSlot<int> slot;
+    slot.put(1);
+    slot.put(2);
+    slot.put(3);
+    EXPECT_EQ(2, slot.getDropped());
+
+    int item = 0;
+    EXPECT_TRUE(slot.take(item));
+    EXPECT_EQ(3, item);
+
+    // the last item is still handed out after close
+    slot.put(4);
+    slot.close();
+    EXPECT_TRUE(slot.take(item));
+    EXPECT_EQ(4, item);
+    EXPECT_FALSE(slot.take(item));
+}
+
+TEST(LatestSlot, newest_only) {
+    // a slow consumer sees increasing items and everything it missed is counted as dropped
+    Stick::LatestSlot<int> slot;
+    const int count = 2000;
+    std::thread producer([&slot]() {
+        for(int i=1; i<=count; i++) {
+            slot.put(i);
+        }
+        slot.close();
+    });
+
+    int last = 0, taken = 0, item = 0;
+    while( slot.take(item) ) {
+        EXPECT_LT(last, item);
+        last = item;
+        taken++;
+        std::this_thread::yield();
+    }
+    producer.join();
+    EXPECT_EQ(count, last);
+    EXPECT_EQ(count, taken + slot.getDropped());
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <parallel/ordered_queue.hpp>
+
+TEST(OrderedQueue, create) {
+    Stick::OrderedQueue<int> queue(4);
+    EXPECT_EQ(4, queue.getCapacity());
+
+    Stick::OrderedQueue<int> minimum(0);
+    EXPECT_EQ(1, minimum.getCapacity());
+}
+
+TEST(OrderedQueue, pop_in_order) {
+    // producers take indices in turn and finish them out of order
+    Stick::OrderedQueue<int> queue(3);
+    std::atomic<int> next(0);
+    std::atomic<int> held(0);
+    std::atomic<int> mostHeld(0);
+    const int count = 200;
+
+    std::vector<std::thread> producers;
+    for(int p=0; p<4; p++) {
+        producers.push_back(std::thread([&queue, &next, &held, &mostHeld, p]() {
+            for(int i=next++; i<count; i=next++) {
+                if( (i + p) % 3 == 0 ) {
+                    std::this_thread::yield();
+                }
+                ASSERT_TRUE(queue.push(i, i*10));
+                int now = ++held;
+                int most = mostHeld;
+                while( now > most && !mostHeld.compare_exchange_weak(most, now) ) {
+                }
+            }
+        }));
+    }
+    for(int i=0; i<count; i++) {
+        int item = -1;
+        ASSERT_TRUE(queue.pop(item));
+        held--;
+        EXPECT_EQ(i*10, item);
+    }
+    for(std::thread& producer : producers) {
+        producer.join();
+    }
+    // counted after the push returned, one more item than the capacity can be in flight
+    EXPECT_LE(mostHeld, queue.getCapacity() + 1);
+}
+
+TEST(OrderedQueue, close) {
+    Stick::OrderedQueue<int> queue(2);
+    EXPECT_TRUE(queue.push(1, 1));
+
+    // index 2 is two ahead of the next pop and blocks until closed
+    bool pushed = true;
+    std::thread producer([&queue, &pushed]() {
+        pushed = queue.push(2, 2);
+    });
+    std::thread consumer([&queue]() {
+        int item;
+        queue.pop(item);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    producer.join();
+    consumer.join();
+    EXPECT_FALSE(pushed);
+
+    int item;
+    EXPECT_FALSE(queue.pop(item));
+    EXPECT_FALSE(queue.push(0, 0));
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <parallel/thread_pool.hpp>
+
+TEST(ThreadPool, create) {
+    Stick::ThreadPool pool(3);
+    EXPECT_EQ(3, pool.getThreads());
+
+    Stick::ThreadPool hardware;
+    EXPECT_LE(1, hardware.getThreads());
+}
+
+TEST(ThreadPool, run) {
+    Stick::ThreadPool pool(4);
+    for(int count=0; count<40; count++) {
+        std::vector<int> calls(count, 0);
+        pool.run(count, [&calls](int i) {
+            calls[i]++;
+        });
+        for(int i=0; i<count; i++) {
+            EXPECT_EQ(1, calls[i]);
+        }
+    }
+}
+
+TEST(ThreadPool, run_uneven) {
+    // the slow tasks sit in the first range, the other workers steal them
+    Stick::ThreadPool pool(4);
+    std::vector<int> calls(64, 0);
+    std::atomic<int> sum(0);
+    pool.run(calls.size(), [&calls, &sum](int i) {
+        volatile double x = 0.0;
+        for(int k=0; k<(i < 16 ? 200000 : 10); k++) {
+            x = x + k;
+        }
+        calls[i]++;
+        sum += i;
+    });
+    for(int i=0; i<calls.size(); i++) {
+        EXPECT_EQ(1, calls[i]);
+    }
+    EXPECT_EQ(63*64/2, sum.load());
+}
+
+TEST(ThreadPool, run_exception) {
+    Stick::ThreadPool pool(2);
+    std::atomic<int> calls(0);
+    EXPECT_THROW(pool.run(10, [&calls](int i) {
+        calls++;
+        if( i == 3 ) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+    EXPECT_EQ(10, calls.load());
+
+    pool.run(5, [&calls](int i) {
+        calls++;
+    });
+    EXPECT_EQ(15, calls.load());
+}
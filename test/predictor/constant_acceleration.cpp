@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include <predictor/constant_acceleration.hpp>
+
+static cv::Matx33d translation(double x, double y) {
+    return cv::Matx33d(1.0, 0.0, x, 0.0, 1.0, y, 0.0, 0.0, 1.0);
+}
+
+TEST(ConstantAcceleration, create) {
+    Stick::ConstantAcceleration predictor;
+    EXPECT_EQ("ConstantAcceleration", predictor.getName());
+}
+
+TEST(ConstantAcceleration, predict) {
+    Stick::ConstantAcceleration predictor;
+
+    cv::Matx33d pose = translation(0.0, 0.0);
+    EXPECT_EQ(pose, predictor.predict(pose));
+    predictor.update(pose);
+    EXPECT_EQ(pose, predictor.predict(pose));
+
+    predictor.update(translation(1.0, 0.0));
+    EXPECT_EQ(translation(2.0, 0.0), predictor.predict(translation(1.0, 0.0)));
+
+    predictor.update(translation(4.0, 0.0));
+    EXPECT_EQ(translation(9.0, 0.0), predictor.predict(translation(4.0, 0.0)));
+
+    predictor.reset();
+    EXPECT_EQ(pose, predictor.predict(pose));
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include <predictor/constant_velocity.hpp>
+
+static cv::Matx33d translation(double x, double y) {
+    return cv::Matx33d(1.0, 0.0, x, 0.0, 1.0, y, 0.0, 0.0, 1.0);
+}
+
+TEST(ConstantVelocity, create) {
+    Stick::ConstantVelocity predictor;
+    EXPECT_EQ("ConstantVelocity", predictor.getName());
+}
+
+TEST(ConstantVelocity, predict) {
+    Stick::ConstantVelocity predictor;
+
+    cv::Matx33d pose = translation(1.0, 2.0);
+    EXPECT_EQ(pose, predictor.predict(pose));
+    predictor.update(pose);
+    EXPECT_EQ(pose, predictor.predict(pose));
+
+    predictor.update(translation(3.0, 1.0));
+    cv::Matx33d predicted = predictor.predict(translation(3.0, 1.0));
+    EXPECT_EQ(translation(5.0, 0.0), predicted);
+
+    predictor.reset();
+    EXPECT_EQ(pose, predictor.predict(pose));
+}
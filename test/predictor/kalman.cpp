@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include <predictor/kalman.hpp>
+
+static cv::Matx33d translation(double x, double y) {
+    return cv::Matx33d(1.0, 0.0, x, 0.0, 1.0, y, 0.0, 0.0, 1.0);
+}
+
+TEST(Kalman, create) {
+    Stick::Kalman predictor;
+    EXPECT_EQ("Kalman", predictor.getName());
+}
+
+TEST(Kalman, predict) {
+    Stick::Kalman predictor(0.1, 1.0);
+
+    cv::Matx33d pose = translation(0.0, 0.0);
+    EXPECT_EQ(pose, predictor.predict(pose));
+
+    for(int t=0; t<50; t++) {
+        predictor.update(translation(2.0*t, -1.0*t));
+    }
+    cv::Matx33d predicted = predictor.predict(translation(98.0, -49.0));
+    EXPECT_NEAR(100.0, predicted(0, 2), 0.1);
+    EXPECT_NEAR(-50.0, predicted(1, 2), 0.1);
+    EXPECT_NEAR(1.0, predicted(0, 0), 1e-9);
+    EXPECT_EQ(1.0, predicted(2, 2));
+
+    predictor.reset();
+    EXPECT_EQ(pose, predictor.predict(pose));
+}
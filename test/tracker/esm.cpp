@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+#include <tracker/esm.hpp>
+#include <tracker/inverse_compositional.hpp>
+#include <model/homography.hpp>
+
+TEST(ESM, create) {
+    Stick::ESM tracker(new Stick::Homography());
+    EXPECT_EQ("ESM", tracker.getName());
+
+    Stick::ESMF trackerFloat(new Stick::Homography());
+    EXPECT_EQ("ESMF", trackerFloat.getName());
+}
+
+TEST(ESM, calculate_track) {
+    Stick::ESM tracker(new Stick::Homography());
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+
+    tracker.setTemplateImage( templateImage );
+    tracker.setKeepDebugImages( true );
+    tracker.initialize();
+
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.track( image );
+    std::cout << tracker.getLogString() << std::endl;
+    EXPECT_LT(0, tracker.getPoseTrace().size());
+}
+
+TEST(ESM, calculate_track_pyramid_large_motion) {
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+
+    cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+    motion.at<double>(0, 2) = 12.0;
+    motion.at<double>(1, 2) = -8.0;
+    motion.at<double>(0, 1) = 0.03;
+    cv::Mat moved;
+    cv::warpPerspective(image, moved, motion, image.size());
+
+    Stick::InverseCompositional* trackers[] = {
+        new Stick::InverseCompositional(new Stick::Homography(), 0.05, 100, 3),
+        new Stick::ESM(new Stick::Homography(), 0.05, 100, 3)
+    };
+    for(Stick::InverseCompositional* tracker : trackers) {
+        tracker->calculateTransformedImage(image, cv::Size(150, 150));
+        tracker->setTemplateImage( tracker->getTransformedImage() );
+        tracker->initialize();
+        tracker->track( moved );
+        std::cout << tracker->getName() << " " << tracker->getLogString() << std::endl;
+    }
+
+    // the motion in template coordinates, the template is cut from the image centre
+    cv::Mat centre = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+    centre.at<double>(0, 2) = image.size().width/2 - 75;
+    centre.at<double>(1, 2) = image.size().height/2 - 75;
+    cv::Mat expected = centre.inv() * motion * centre;
+
+    cv::Mat pose = trackers[1]->getModel()->get();
+    EXPECT_NEAR(expected.at<double>(0, 2), pose.at<double>(0, 2), 0.5);
+    EXPECT_NEAR(expected.at<double>(1, 2), pose.at<double>(1, 2), 0.5);
+    EXPECT_NEAR(expected.at<double>(0, 1), pose.at<double>(0, 1), 0.005);
+    EXPECT_LE(trackers[1]->getIterations(), trackers[0]->getIterations());
+
+    for(Stick::InverseCompositional* tracker : trackers) {
+        delete tracker;
+    }
+}
+
+TEST(ESM, calculate_track_small_motion) {
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+
+    cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+    motion.at<double>(0, 2) = 2.0;
+    motion.at<double>(1, 2) = -1.0;
+    motion.at<double>(0, 1) = 0.01;
+    cv::Mat moved;
+    cv::warpPerspective(image, moved, motion, image.size());
+
+    Stick::InverseCompositional inverseCompositional(new Stick::Homography(), 0.05, 100, 1);
+    Stick::ESM esm(new Stick::Homography(), 0.05, 100, 1);
+    Stick::InverseCompositional* trackers[] = {&inverseCompositional, &esm};
+    for(Stick::InverseCompositional* tracker : trackers) {
+        tracker->calculateTransformedImage(image, cv::Size(150, 150));
+        tracker->setTemplateImage( tracker->getTransformedImage() );
+        tracker->initialize();
+        tracker->track( moved );
+        EXPECT_EQ(Stick::InverseCompositional::Converged, tracker->getStatus());
+    }
+
+    // whole second-order steps, the error shrinks quadratically and a few iterations reach the motion
+    std::cout << "inverse compositional:" << inverseCompositional.getIterations() << ", esm:" << esm.getIterations() << std::endl;
+    EXPECT_LE(esm.getIterations(), 6);
+    EXPECT_LT(2*esm.getIterations(), inverseCompositional.getIterations());
+
+    cv::Mat centre = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+    centre.at<double>(0, 2) = image.size().width/2 - 75;
+    centre.at<double>(1, 2) = image.size().height/2 - 75;
+    cv::Mat expected = centre.inv() * motion * centre;
+    cv::Mat actual = esm.getModel()->get();
+    EXPECT_NEAR(expected.at<double>(0, 2), actual.at<double>(0, 2), 0.05);
+    EXPECT_NEAR(expected.at<double>(1, 2), actual.at<double>(1, 2), 0.05);
+    EXPECT_NEAR(expected.at<double>(0, 1), actual.at<double>(0, 1), 0.001);
+}
+
+TEST(ESM, calculate_track_singular) {
+    // without texture in the template or the frame there is no update, which is not convergence
+    cv::Mat flat(200, 200, CV_8UC1, cv::Scalar(128));
+    Stick::ESM tracker(new Stick::Homography(), 0.05, 100, 1);
+    tracker.calculateTransformedImage(flat, cv::Size(64, 64));
+    tracker.setTemplateImage( tracker.getTransformedImage() );
+    tracker.initialize();
+    tracker.track( flat );
+    EXPECT_EQ(Stick::InverseCompositional::MaxIteration, tracker.getStatus());
+    EXPECT_EQ(1, tracker.getIterations());
+    EXPECT_EQ(cv::Matx33d::eye(), tracker.getModel()->getMatx());
+}
+
+TEST(ESM, calculate_track_threads) {
+    Stick::ESM single(new Stick::Homography(), 0.05, 100, 2);
+    Stick::ESM threaded(new Stick::Homography(), 0.05, 100, 2);
+    threaded.setThreads(4);
+#ifndef _OPENMP
+    // built without ENABLE_OPENMP both trackers run the same serial loop, the comparison could not fail
+    std::cout << "skipped, built without ENABLE_OPENMP" << std::endl;
+    return;
+#endif
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    single.setTemplateImage( templateImage );
+    single.initialize();
+    threaded.setTemplateImage( templateImage );
+    threaded.initialize();
+
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    single.track( image );
+    threaded.track( image );
+
+    cv::Mat expected = single.getModel()->get();
+    cv::Mat actual = threaded.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(expected.at<double>(i), actual.at<double>(i));
+    }
+}
+
+TEST(ESM, share_template_data) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+
+    Stick::ESM own(new Stick::Homography(), 0.05, 100, 2);
+    own.setTemplateImage( templateImage );
+    own.initialize();
+    own.track( image );
+
+    // data of an InverseCompositional gains the jacobians, the steepest descent images stay shared
+    Stick::InverseCompositional inverseCompositional(new Stick::Homography(), 0.05, 100, 2);
+    inverseCompositional.setTemplateImage( templateImage );
+    inverseCompositional.initialize();
+    std::shared_ptr<const Stick::TemplateData> data = inverseCompositional.getTemplateData();
+
+    Stick::ESM shared(new Stick::Homography(), 0.05, 100, 2);
+    shared.setTemplateData( data );
+    EXPECT_TRUE(data->levels[0].jacobians.empty());
+    EXPECT_FALSE(shared.getTemplateData()->levels[0].jacobians.empty());
+    EXPECT_EQ(data->levels[0].steepest.data, shared.getTemplateData()->levels[0].steepest.data);
+    shared.track( image );
+
+    cv::Mat expected = own.getModel()->get();
+    cv::Mat actual = shared.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(expected.at<double>(i), actual.at<double>(i));
+    }
+}
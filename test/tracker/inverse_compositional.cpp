@@ -1,33 +1,56 @@
 #include <gtest/gtest.h>
 
+#include <iostream>
+#include <set>
+
 #include <tracker/inverse_compositional.hpp>
+#include <exceptions/not_initialized.hpp>
 #include <model/homography.hpp>
+#include <model/translation.hpp>
+#include <model/euclidean.hpp>
+#include <model/similarity.hpp>
+#include <model/affine.hpp>
+#include <predictor/constant_velocity.hpp>
+
+#include "allocation.hpp"
 
 namespace Stick {
     class InverseCompositionalTest : public InverseCompositional {
         public:
-            InverseCompositionalTest(Model* model) : InverseCompositional(model) {
+            InverseCompositionalTest(Model* model, int pyramidLevel=1) : InverseCompositional(model, 0.5, 100, pyramidLevel) {
             }
 
+            // the initialization steps one by one on a data object of the test
             void calculateGradients() {
-                InverseCompositional::calculateGradients();
+                this->templateData.reset();
+                InverseCompositional::buildTemplatePyramid(this->steps, this->templateImage);
+                InverseCompositional::calculateGradients(this->steps.levels[0]);
             }
             cv::Mat getGradients() const {
-                return this->gradients.clone();
+                return this->getData().levels[0].gradients.clone();
             }
 
             void calculateSteepest() {
-                InverseCompositional::calculateSteepest();
+                InverseCompositional::calculateSteepest(this->steps.levels[0]);
             }
+            // untiled, one row per parameter
             cv::Mat getSteepest() const {
-                return this->steepest.clone();
+                const Level& level = this->getData().levels[0];
+                int params = this->model->getParameterSize();
+                cv::Mat steepest(params, level.getCount(), cv::DataType<double>::type);
+                for(int p=0; p<params; p++) {
+                    for(int i=0; i<level.getCount(); i++) {
+                        steepest.at<double>(p, i) = level.steepestAt<double>(p, i);
+                    }
+                }
+                return steepest;
             }
 
             void calculateHessianInv() {
-                InverseCompositional::calculateHessianInv();
+                InverseCompositional::calculateHessianInv(this->steps.levels[0]);
             }
             cv::Mat getHessianInv() const {
-                return this->hessianInv.clone();
+                return this->getData().levels[0].hessianInv.clone();
             }
 
             cv::Mat getTransformedImage() const {
@@ -36,9 +59,37 @@ namespace Stick {
             cv::Mat getErrorImage() const {
                 return this->errorImage.clone();
             }
+            cv::Mat accumulateSteepestError(const cv::Mat& image) {
+                this->buildImagePyramid(image);
+                cv::Mat steepestError = cv::Mat::zeros(cv::Size(1, this->model->getParameterSize()), cv::DataType<double>::type);
+                InverseCompositional::accumulateSteepestError(0, this->calculateLevelPose(0), 1.0, steepestError.ptr<double>(0));
+                return steepestError;
+            }
+            std::vector<int> getPixels(int level) const {
+                return this->getData().levels[level].pixels;
+            }
+            cv::Size getLevelSize(int level) const {
+                return this->getData().levels[level].templateImage.size();
+            }
+
+        protected:
+            const TemplateData& getData() const {
+                return this->templateData ? *this->templateData : this->steps;
+            }
+            TemplateData steps;
     };
 }
 
+static cv::Mat invert(const cv::Mat& image) {
+    cv::Mat inverted = image.clone();
+    for(int y=0; y<inverted.rows; y++) {
+        for(int x=0; x<inverted.cols; x++) {
+            inverted.at<unsigned char>(y, x) = 255 - inverted.at<unsigned char>(y, x);
+        }
+    }
+    return inverted;
+}
+
 TEST(InverseCompositional, create) {
     Stick::InverseCompositional tracker(new Stick::Homography());
 }
@@ -94,6 +145,7 @@ TEST(InverseCompositional, calculate_track) {
     cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
 
     tracker.setTemplateImage( templateImage );
+    tracker.setKeepDebugImages( true );
     tracker.initialize();
 
     cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
@@ -105,4 +157,607 @@ TEST(InverseCompositional, calculate_track) {
 
 }
 
+TEST(InverseCompositional, accumulate_steepest_error) {
+    Stick::InverseCompositionalTest tracker(new Stick::Homography());
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.setTemplateImage( templateImage );
+    tracker.initialize();
+
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.calculateTransformedImage(image, templateImage.size());
+
+    cv::Mat transformed, reference;
+    tracker.getTransformedImage().convertTo(transformed, cv::DataType<double>::type);
+    templateImage.convertTo(reference, cv::DataType<double>::type);
+    cv::Mat error = (transformed - reference).reshape(0, templateImage.size().area());
+    cv::Mat expected = tracker.getSteepest() * error;
+
+    cv::Mat actual = tracker.accumulateSteepestError(image);
+    ASSERT_EQ(expected.size(), actual.size());
+    for(int p=0; p<expected.size().area(); p++) {
+        EXPECT_NEAR(expected.at<double>(p), actual.at<double>(p), std::abs(expected.at<double>(p)) * 1e-9);
+    }
+}
+
+TEST(InverseCompositional, build_pyramid) {
+    Stick::InverseCompositionalTest tracker(new Stick::Homography(), 5);
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+
+    tracker.setTemplateImage( templateImage );
+    tracker.initialize();
+
+    EXPECT_EQ(4, tracker.getPyramidLevel());
+    EXPECT_EQ(cv::Size(150, 150), tracker.getLevelSize(0));
+    EXPECT_EQ(cv::Size(75, 75), tracker.getLevelSize(1));
+    EXPECT_EQ(cv::Size(38, 38), tracker.getLevelSize(2));
+    EXPECT_EQ(cv::Size(19, 19), tracker.getLevelSize(3));
+
+    // downsampled like cv::pyrDown, odd sizes included
+    const std::vector<Stick::TrackingLevel>& levels = tracker.getTemplateData()->levels;
+    for(int l=1; l<levels.size(); l++) {
+        cv::Mat expected;
+        cv::pyrDown(levels[l-1].templateImage, expected);
+        ASSERT_EQ(expected.size(), levels[l].templateImage.size());
+        for(int y=0; y<expected.rows; y++) {
+            for(int x=0; x<expected.cols; x++) {
+                EXPECT_NEAR(expected.at<unsigned char>(y, x), levels[l].templateImage.at<unsigned char>(y, x), 1);
+            }
+        }
+    }
+}
+
+TEST(InverseCompositional, calculate_track_pyramid) {
+    Stick::InverseCompositional single(new Stick::Homography());
+    Stick::InverseCompositional pyramid(new Stick::Homography(), 0.5, 100, 3);
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    single.setTemplateImage( templateImage );
+    single.initialize();
+    pyramid.setTemplateImage( templateImage );
+    pyramid.initialize();
+
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    single.track( image );
+    pyramid.track( image );
+    std::cout << pyramid.getLogString() << std::endl;
+
+    cv::Mat expected = single.getModel()->get();
+    cv::Mat actual = pyramid.getModel()->get();
+    EXPECT_NEAR(expected.at<double>(0, 2), actual.at<double>(0, 2), 0.5);
+    EXPECT_NEAR(expected.at<double>(1, 2), actual.at<double>(1, 2), 0.5);
+}
+
+TEST(InverseCompositional, calculate_track_pyramid_large_motion) {
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 3);
+
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+    tracker.calculateTransformedImage(image, cv::Size(150, 150));
+    tracker.setTemplateImage( tracker.getTransformedImage() );
+    tracker.initialize();
+
+    cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+    motion.at<double>(0, 2) = 12.0;
+    motion.at<double>(1, 2) = -8.0;
+    cv::Mat moved;
+    cv::warpPerspective(image, moved, motion, image.size());
+
+    tracker.track( moved );
+    std::cout << tracker.getLogString() << std::endl;
+
+    cv::Mat pose = tracker.getModel()->get();
+    EXPECT_NEAR(12.0, pose.at<double>(0, 2), 0.5);
+    EXPECT_NEAR(-8.0, pose.at<double>(1, 2), 0.5);
+}
+
+TEST(InverseCompositional, calculate_track_lower_dof) {
+    Stick::Model* models[] = {new Stick::Translation(), new Stick::Euclidean(), new Stick::Similarity(), new Stick::Affine()};
+    for(Stick::Model* model : models) {
+        Stick::InverseCompositional tracker(model, 0.05, 100, 3);
+
+        cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+        cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+        tracker.calculateTransformedImage(image, cv::Size(150, 150));
+        tracker.setTemplateImage( tracker.getTransformedImage() );
+        tracker.initialize();
+
+        cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+        motion.at<double>(0, 2) = 12.0;
+        motion.at<double>(1, 2) = -8.0;
+        cv::Mat moved;
+        cv::warpPerspective(image, moved, motion, image.size());
+
+        tracker.track( moved );
+        std::cout << model->getName() << " " << tracker.getLogString() << std::endl;
+
+        cv::Mat pose = model->get();
+        EXPECT_NEAR(12.0, pose.at<double>(0, 2), 0.5);
+        EXPECT_NEAR(-8.0, pose.at<double>(1, 2), 0.5);
+    }
+}
+
+TEST(InverseCompositional, select_pixels) {
+    Stick::InverseCompositionalTest tracker(new Stick::Homography());
+    EXPECT_THROW(tracker.setPixelFraction(0.0), Stick::InvalidParameters);
+    EXPECT_THROW(tracker.setPixelFraction(1.5), Stick::InvalidParameters);
+    tracker.setPixelFraction(0.15);
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.setTemplateImage( templateImage );
+    tracker.initialize();
+
+    std::vector<int> pixels = tracker.getPixels(0);
+    int count = (int)(0.15 * templateImage.size().area() + 0.5);
+    ASSERT_EQ(count, pixels.size());
+    EXPECT_EQ(cv::Size(count, 8), tracker.getSteepest().size());
+    for(int i=1; i<pixels.size(); i++) {
+        EXPECT_LT(pixels[i-1], pixels[i]);
+    }
+
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.calculateTransformedImage(image, templateImage.size());
+
+    cv::Mat transformed;
+    tracker.getTransformedImage().convertTo(transformed, cv::DataType<double>::type);
+    cv::Mat error = cv::Mat::zeros(cv::Size(1, count), cv::DataType<double>::type);
+    for(int i=0; i<count; i++) {
+        int x = pixels[i] % templateImage.size().width;
+        int y = pixels[i] / templateImage.size().width;
+        error.at<double>(i) = transformed.at<double>(y, x) - templateImage.at<unsigned char>(y, x);
+    }
+    cv::Mat expected = tracker.getSteepest() * error;
+
+    cv::Mat actual = tracker.accumulateSteepestError(image);
+    for(int p=0; p<expected.size().area(); p++) {
+        EXPECT_NEAR(expected.at<double>(p), actual.at<double>(p), std::abs(expected.at<double>(p)) * 1e-9);
+    }
+}
+
+TEST(InverseCompositional, calculate_track_selected_pixels) {
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 3);
+    tracker.setPixelFraction(0.15);
+
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+    tracker.calculateTransformedImage(image, cv::Size(150, 150));
+    tracker.setTemplateImage( tracker.getTransformedImage() );
+    tracker.initialize();
+
+    cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+    motion.at<double>(0, 2) = 12.0;
+    motion.at<double>(1, 2) = -8.0;
+    cv::Mat moved;
+    cv::warpPerspective(image, moved, motion, image.size());
+
+    tracker.track( moved );
+    std::cout << tracker.getLogString() << std::endl;
+
+    cv::Mat pose = tracker.getModel()->get();
+    EXPECT_NEAR(12.0, pose.at<double>(0, 2), 0.5);
+    EXPECT_NEAR(-8.0, pose.at<double>(1, 2), 0.5);
+}
+
+TEST(InverseCompositional, calculate_track_predictor) {
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+
+    // without predictor, with it, and with it while measuring what it saves
+    int iterations[3] = {0, 0, 0};
+    int saved = 0;
+    cv::Matx33d poses[3];
+    for(int run=0; run<3; run++) {
+        Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+        if( run >= 1 ) {
+            tracker.setPredictor(new Stick::ConstantVelocity());
+        }
+        tracker.setMeasurePrediction( run == 2 );
+        tracker.calculateTransformedImage(image, cv::Size(150, 150));
+        tracker.setTemplateImage( tracker.getTransformedImage() );
+        tracker.initialize();
+
+        // steady motion of 3px right and 2px up per frame
+        for(int t=1; t<=6; t++) {
+            cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+            motion.at<double>(0, 2) = 3.0*t;
+            motion.at<double>(1, 2) = -2.0*t;
+            cv::Mat moved;
+            cv::warpPerspective(image, moved, motion, image.size());
+
+            tracker.track( moved );
+            iterations[run] += tracker.getIterations();
+            if( run == 2 ) {
+                saved += tracker.getSavedIterations();
+            } else {
+                EXPECT_EQ(0, tracker.getSavedIterations());
+            }
+        }
+        std::cout << tracker.getLogString() << std::endl;
+        poses[run] = tracker.getModel()->getMatx();
+
+        cv::Mat pose = tracker.getModel()->get();
+        EXPECT_NEAR(18.0, pose.at<double>(0, 2), 0.5);
+        EXPECT_NEAR(-12.0, pose.at<double>(1, 2), 0.5);
+    }
+    std::cout << "iterations without predictor:" << iterations[0] << ", with:" << iterations[1] << ", saved:" << saved << std::endl;
+    EXPECT_LT(iterations[1], iterations[0]);
+    EXPECT_LT(0, saved);
+
+    // measuring leaves the predicted run as it was
+    EXPECT_EQ(iterations[1], iterations[2]);
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(poses[1].val[i], poses[2].val[i]);
+    }
+}
+
+TEST(InverseCompositional, calculate_track_time_budget) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+
+    Stick::InverseCompositional unlimited(new Stick::Homography(), 0.05, 100);
+    unlimited.setTemplateImage( templateImage );
+    unlimited.initialize();
+    unlimited.track( image );
+    EXPECT_EQ(Stick::InverseCompositional::Converged, unlimited.getStatus());
+
+    // a budget that is always exceeded stops after the first iteration with the only pose evaluated
+    Stick::InverseCompositional tight(new Stick::Homography(), 0.05, 100);
+    tight.setTimeBudget(1e-6);
+    tight.setTemplateImage( templateImage );
+    tight.initialize();
+    tight.track( image );
+    std::cout << tight.getLogString() << std::endl;
+    EXPECT_EQ(Stick::InverseCompositional::TimedOut, tight.getStatus());
+    EXPECT_EQ(1, tight.getIterations());
+    cv::Mat pose = tight.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(i%4 == 0 ? 1.0 : 0.0, pose.at<double>(i));
+    }
+
+    Stick::InverseCompositional loose(new Stick::Homography(), 0.05, 100);
+    loose.setTimeBudget(60000.0);
+    loose.setTemplateImage( templateImage );
+    loose.initialize();
+    loose.track( image );
+    EXPECT_EQ(Stick::InverseCompositional::Converged, loose.getStatus());
+    EXPECT_EQ(unlimited.getIterations(), loose.getIterations());
+}
+
+TEST(InverseCompositional, calculate_track_adaptive_iterations) {
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    tracker.setAdaptiveIterations(true);
+
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+    tracker.calculateTransformedImage(image, cv::Size(150, 150));
+    tracker.setTemplateImage( tracker.getTransformedImage() );
+    tracker.initialize();
+    EXPECT_EQ(200, tracker.getIterationCap());
+
+    // easy frames of one pixel motion
+    int most = 0;
+    for(int t=1; t<=8; t++) {
+        cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+        motion.at<double>(0, 2) = 1.0*t;
+        cv::Mat moved;
+        cv::warpPerspective(image, moved, motion, image.size());
+
+        tracker.track( moved );
+        EXPECT_EQ(Stick::InverseCompositional::Converged, tracker.getStatus());
+        most = std::max(most, tracker.getIterations());
+    }
+    int cap = tracker.getIterationCap();
+    EXPECT_EQ(std::max(8, 2*most), cap);
+
+    // a frame the template is not in runs into the cap instead of the full 2x100 iterations
+    cv::Mat blank(image.size(), image.type(), cv::Scalar(128));
+    tracker.track( blank );
+    EXPECT_LE(tracker.getIterations(), cap);
+    EXPECT_NE(Stick::InverseCompositional::Converged, tracker.getStatus());
+
+    tracker.initialize();
+    EXPECT_EQ(200, tracker.getIterationCap());
+}
+
+TEST(InverseCompositional, calculate_track_adaptive_iterations_recover) {
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    tracker.setAdaptiveIterations(true);
+
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+    tracker.calculateTransformedImage(image, cv::Size(150, 150));
+    tracker.setTemplateImage( tracker.getTransformedImage() );
+    tracker.initialize();
+
+    // easy frames of one pixel motion shrink the cap, then harder but trackable frames of six pixels
+    // run into it and raise it again
+    double x = 0.0;
+    int easyCap = 0;
+    bool capped = false;
+    for(int t=1; t<=16; t++) {
+        x += t <= 8 ? 1.0 : 6.0;
+        cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+        motion.at<double>(0, 2) = x;
+        cv::Mat moved;
+        cv::warpPerspective(image, moved, motion, image.size());
+
+        if( t == 9 ) {
+            easyCap = tracker.getIterationCap();
+        }
+        tracker.track( moved );
+        if( t > 8 && tracker.getStatus() != Stick::InverseCompositional::Converged ) {
+            EXPECT_GE(tracker.getIterationCap(), std::min(200, 2*tracker.getIterations()));
+            capped = true;
+        }
+    }
+    EXPECT_TRUE(capped);
+    EXPECT_GT(tracker.getIterationCap(), easyCap);
+    EXPECT_EQ(Stick::InverseCompositional::Converged, tracker.getStatus());
+    EXPECT_NEAR(x, tracker.getModel()->getMatx()(0, 2), 0.1);
+}
+
+TEST(InverseCompositional, calculate_track_float) {
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    Stick::InverseCompositionalF trackerFloat(new Stick::Homography(), 0.05, 100, 2);
+    EXPECT_EQ("InverseCompositionalF", trackerFloat.getName());
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.setTemplateImage( templateImage );
+    tracker.initialize();
+    trackerFloat.setTemplateImage( templateImage );
+    trackerFloat.initialize();
+
+    cv::Mat image = cv::imread("datas/im001.png", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.track( image );
+    trackerFloat.track( image );
+    std::cout << tracker.getLogString() << std::endl;
+    std::cout << trackerFloat.getLogString() << std::endl;
+
+    // corners of the template agree within a tenth of a pixel
+    cv::Mat expected = tracker.getModel()->get();
+    cv::Mat actual = trackerFloat.getModel()->get();
+    for(int i=0; i<4; i++) {
+        cv::Mat corner = cv::Mat::ones(3, 1, cv::DataType<double>::type);
+        corner.at<double>(0) = (i%2) * templateImage.cols;
+        corner.at<double>(1) = (i/2) * templateImage.rows;
+        cv::Mat a = expected * corner;
+        cv::Mat b = actual * corner;
+        EXPECT_NEAR(a.at<double>(0)/a.at<double>(2), b.at<double>(0)/b.at<double>(2), 0.1);
+        EXPECT_NEAR(a.at<double>(1)/a.at<double>(2), b.at<double>(1)/b.at<double>(2), 0.1);
+    }
+}
+
+TEST(InverseCompositional, share_template_data) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+
+    Stick::InverseCompositional first(new Stick::Homography(), 0.05, 100, 2);
+    first.setTemplateImage( templateImage );
+    first.initialize();
+    std::shared_ptr<const Stick::TemplateData> data = first.getTemplateData();
+    ASSERT_TRUE((bool)data);
+    EXPECT_EQ(2, data->levels.size());
+
+    Stick::InverseCompositional second(new Stick::Homography(), 0.05, 100, 2);
+    second.setTemplateData( data );
+    EXPECT_EQ(data.get(), second.getTemplateData().get());
+    EXPECT_EQ(2, second.getPyramidLevel());
+
+    // a new template of the same size does not touch the shared one
+    first.setTemplateImage( invert(templateImage) );
+    for(int y=0; y<templateImage.rows; y++) {
+        ASSERT_EQ(0, memcmp(templateImage.ptr(y), data->levels[0].templateImage.ptr(y), templateImage.cols));
+    }
+
+    first.track( image );
+    second.track( image );
+    cv::Mat expected = first.getModel()->get();
+    cv::Mat actual = second.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(expected.at<double>(i), actual.at<double>(i));
+    }
+
+    // other models and scalar types need their own data
+    Stick::InverseCompositional affine(new Stick::Affine());
+    EXPECT_THROW(affine.setTemplateData( data ), Stick::InvalidParameters);
+    Stick::InverseCompositionalF single(new Stick::Homography());
+    EXPECT_THROW(single.setTemplateData( data ), Stick::InvalidParameters);
+    EXPECT_THROW(single.setTemplateData( std::shared_ptr<const Stick::TemplateData>() ), Stick::InvalidParameters);
+}
+
+TEST(InverseCompositional, calculate_track_region) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Rect frame(0, 0, image.cols, image.rows);
+
+    Stick::InverseCompositional whole(new Stick::Homography(), 0.05, 100, 2);
+    whole.setTemplateImage( templateImage );
+    whole.initialize();
+    EXPECT_EQ(frame, whole.getRegion(image.size()));
+    whole.track( image );
+
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    EXPECT_THROW(tracker.setRegionMargin(-1), Stick::InvalidParameters);
+    tracker.setRegionMargin( 32 );
+    tracker.setTemplateImage( templateImage );
+    tracker.initialize();
+
+    // the template centred in the frame, grown by the margin, the origin on the grid of the coarser level
+    cv::Rect region = tracker.getRegion(image.size());
+    int left = image.cols/2 - templateImage.cols/2 - 32;
+    int top = image.rows/2 - templateImage.rows/2 - 32;
+    EXPECT_EQ(left - left % 2, region.x);
+    EXPECT_EQ(top - top % 2, region.y);
+    EXPECT_EQ(left + templateImage.cols + 2*32 + 1, region.x + region.width);
+    EXPECT_EQ(top + templateImage.rows + 2*32 + 1, region.y + region.height);
+    EXPECT_EQ(region, region & frame);
+    EXPECT_LT(region.area(), frame.area());
+
+    // only the region needs to hold valid pixels
+    cv::Mat cropped(image.size(), image.type(), cv::Scalar(0));
+    cv::Mat inside = cropped(region);
+    image(region).copyTo(inside);
+    tracker.track( cropped );
+    cv::Point offset(image.cols/2 - templateImage.cols/2, image.rows/2 - templateImage.rows/2);
+    cv::Rect next = tracker.getRegion(image.size());
+    for(int i=0; i<4; i++) {
+        cv::Point corner((i%2) * templateImage.cols, (i/2) * templateImage.rows);
+        cv::Point expected = whole.getModel()->transform(corner);
+        cv::Point actual = tracker.getModel()->transform(corner);
+        EXPECT_NEAR(expected.x, actual.x, 1);
+        EXPECT_NEAR(expected.y, actual.y, 1);
+        // the next region follows the pose
+        EXPECT_TRUE(next.contains(actual + offset));
+    }
+
+    // blurring only the next region gives the pixels of blurring the whole frame there
+    cv::Mat blurred, expectedBlurred;
+    tracker.blurRegion(image, blurred, cv::Size(5, 5), 2.0);
+    cv::GaussianBlur(image, expectedBlurred, cv::Size(5, 5), 2.0, 2.0);
+    ASSERT_EQ(image.size(), blurred.size());
+    cv::Rect inner(next.x + 2, next.y + 2, next.width - 4, next.height - 4);
+    int different = 0;
+    for(int y=inner.y; y<inner.y+inner.height; y++) {
+        for(int x=inner.x; x<inner.x+inner.width; x++) {
+            different += blurred.at<unsigned char>(y, x) != expectedBlurred.at<unsigned char>(y, x) ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(0, different);
+}
+
+TEST(InverseCompositional, initialize_async) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat inverted = invert(templateImage);
+
+    Stick::InverseCompositional expected(new Stick::Homography(), 0.05, 100, 2);
+    expected.setTemplateImage( templateImage );
+    expected.initialize();
+    expected.track( image );
+
+    // built in the background, switched to by the next frame
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    tracker.setTemplateImage( inverted );
+    tracker.initialize();
+    std::shared_ptr<const Stick::TemplateData> previous = tracker.getTemplateData();
+    std::shared_future<void> ready = tracker.initializeAsync( templateImage );
+    ready.get();
+    EXPECT_EQ(previous.get(), tracker.getTemplateData().get());
+    tracker.track( image );
+    EXPECT_NE(previous.get(), tracker.getTemplateData().get());
+    EXPECT_FALSE(tracker.updateTemplate());
+
+    cv::Mat actual = tracker.getModel()->get();
+    cv::Mat pose = expected.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(pose.at<double>(i), actual.at<double>(i));
+    }
+
+    // only the latest request is switched to, initialize() drops what is not switched to yet
+    tracker.initializeAsync( inverted );
+    tracker.initializeAsync( templateImage ).get();
+    EXPECT_TRUE(tracker.updateTemplate());
+    EXPECT_EQ(0, memcmp(templateImage.ptr(0), tracker.getTemplateData()->levels[0].templateImage.ptr(0), templateImage.cols));
+    tracker.initializeAsync( inverted ).get();
+    tracker.initialize();
+    EXPECT_FALSE(tracker.updateTemplate());
+
+    // a failed build leaves the current template in place
+    std::shared_future<void> failed = tracker.initializeAsync( cv::Mat() );
+    EXPECT_THROW(failed.get(), Stick::NotInitialized);
+    EXPECT_FALSE(tracker.updateTemplate());
+
+    // an uninitialized tracker starts tracking with its first built template
+    Stick::InverseCompositional later(new Stick::Homography(), 0.05, 100, 2);
+    EXPECT_THROW(later.track( image ), Stick::NotInitialized);
+    later.initializeAsync( templateImage ).wait();
+    later.track( image );
+    EXPECT_EQ(2, later.getPyramidLevel());
+}
+
+TEST(InverseCompositional, calculate_track_threads) {
+    Stick::InverseCompositional single(new Stick::Homography(), 0.05, 100, 2);
+    Stick::InverseCompositional threaded(new Stick::Homography(), 0.05, 100, 2);
+    threaded.setThreads(4);
+    EXPECT_EQ(4, threaded.getThreads());
+#ifndef _OPENMP
+    // built without ENABLE_OPENMP both trackers run the same serial loop, the comparison could not fail
+    std::cout << "skipped, built without ENABLE_OPENMP" << std::endl;
+    return;
+#endif
 
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    single.setTemplateImage( templateImage );
+    single.initialize();
+    threaded.setTemplateImage( templateImage );
+    threaded.initialize();
+
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    single.track( image );
+    threaded.track( image );
+
+    cv::Mat expected = single.getModel()->get();
+    cv::Mat actual = threaded.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(expected.at<double>(i), actual.at<double>(i));
+    }
+}
+
+TEST(InverseCompositional, calculate_track_no_allocation) {
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100);
+
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.setTemplateImage( templateImage );
+    tracker.initialize();
+
+    cv::Mat first = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat second = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    tracker.track( first );
+
+    Allocation::start();
+    tracker.track( second );
+    tracker.track( first );
+    int allocations = Allocation::stop();
+
+    EXPECT_EQ(0, allocations);
+    EXPECT_LT(0, tracker.getPoseTrace().size());
+}
+
+TEST(InverseCompositional, calculate_track_region_no_allocation) {
+    cv::Mat image = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::GaussianBlur(image, image, cv::Size(5, 5), 2.0, 2.0);
+
+    // two levels, the coarser one is downsampled into its buffer without the scratch memory of cv::pyrDown
+    Stick::InverseCompositional tracker(new Stick::Homography(), 0.05, 100, 2);
+    tracker.setRegionMargin( 16 );
+    tracker.calculateTransformedImage(image, cv::Size(100, 100));
+    tracker.setTemplateImage( tracker.getTransformedImage() );
+    tracker.initialize();
+
+    // the template moves towards the right edge of the frame, where the region gets clipped and changes size
+    int right = image.cols/2 + 50 + 16;
+    int steps = (image.cols - right)/4 + 4;
+    std::vector<cv::Mat> frames;
+    for(int t=0; t<=steps; t++) {
+        cv::Mat motion = cv::Mat::eye(3, 3, cv::DataType<double>::type);
+        motion.at<double>(0, 2) = 4.0*t;
+        cv::Mat moved;
+        cv::warpPerspective(image, moved, motion, image.size());
+        frames.push_back(moved);
+    }
+    tracker.track( frames[0] );
+
+    std::set<int> widths;
+    int allocations = 0;
+    for(int t=1; t<=steps; t++) {
+        widths.insert(tracker.getRegion(image.size()).width);
+        Allocation::start();
+        tracker.track( frames[t] );
+        allocations += Allocation::stop();
+        EXPECT_EQ(Stick::InverseCompositional::Converged, tracker.getStatus());
+    }
+    EXPECT_LT(1u, widths.size());
+    EXPECT_EQ(0, allocations);
+    EXPECT_NEAR(4.0*steps, tracker.getModel()->getMatx()(0, 2), 0.5);
+}
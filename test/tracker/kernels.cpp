@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include <tracker/kernels.hpp>
+
+static std::vector<unsigned char> randomPixels(int size, unsigned int seed) {
+    std::vector<unsigned char> pixels(size);
+    srand(seed);
+    for(int i=0; i<size; i++) {
+        pixels[i] = (unsigned char)(rand() % 256);
+    }
+    return pixels;
+}
+
+static std::vector<double> randomValues(int size, unsigned int seed) {
+    std::vector<double> values(size);
+    srand(seed);
+    for(int i=0; i<size; i++) {
+        values[i] = (double)(rand() % 20001 - 10000) / 37.0;
+    }
+    return values;
+}
+
+TEST(Kernels, available) {
+    std::vector<const Stick::Kernels::Table*> tables = Stick::Kernels::getAvailable();
+    ASSERT_LE(1u, tables.size());
+    EXPECT_EQ(&Stick::Kernels::Scalar, tables[0]);
+    EXPECT_EQ(tables.back(), &Stick::Kernels::get());
+}
+
+TEST(Kernels, select) {
+    std::string fastest = Stick::Kernels::get().name;
+
+    EXPECT_TRUE(Stick::Kernels::select("scalar"));
+    EXPECT_EQ(&Stick::Kernels::Scalar, &Stick::Kernels::get());
+    EXPECT_FALSE(Stick::Kernels::select("unknown"));
+    EXPECT_EQ(&Stick::Kernels::Scalar, &Stick::Kernels::get());
+
+    EXPECT_TRUE(Stick::Kernels::select(fastest));
+}
+
+TEST(Kernels, gradient_row) {
+    for(const Stick::Kernels::Table* kernels : Stick::Kernels::getAvailable()) {
+        for(int width=1; width<40; width++) {
+            std::vector<unsigned char> image = randomPixels(width*3, width);
+            std::vector<double> dx(width, -1.0), dy(width, -1.0);
+            kernels->gradientRow(&image[0], &image[width], &image[2*width], width, 0.5, &dx[0], &dy[0]);
+
+            EXPECT_EQ(0.0, dx[0]) << kernels->name;
+            EXPECT_EQ(0.0, dy[0]) << kernels->name;
+            EXPECT_EQ(0.0, dx[width-1]) << kernels->name;
+            EXPECT_EQ(0.0, dy[width-1]) << kernels->name;
+            for(int x=1; x<width-1; x++) {
+                EXPECT_EQ(((double)image[width+x+1] - (double)image[width+x-1]) * 0.5, dx[x]) << kernels->name;
+                EXPECT_EQ(((double)image[2*width+x] - (double)image[x]) * 0.5, dy[x]) << kernels->name;
+            }
+        }
+    }
+}
+
+TEST(Kernels, steepest_row) {
+    for(const Stick::Kernels::Table* kernels : Stick::Kernels::getAvailable()) {
+        for(int width=1; width<40; width++) {
+            std::vector<double> values = randomValues(width*4, width);
+            std::vector<double> out(width);
+            kernels->steepestRow(&values[0], &values[width], &values[2*width], &values[3*width], width, &out[0]);
+            for(int x=0; x<width; x++) {
+                EXPECT_EQ(values[x] * values[2*width+x] + values[width+x] * values[3*width+x], out[x]) << kernels->name;
+            }
+        }
+    }
+}
+
+TEST(Kernels, error_row) {
+    for(const Stick::Kernels::Table* kernels : Stick::Kernels::getAvailable()) {
+        for(int width=1; width<40; width++) {
+            std::vector<double> sampled = randomValues(width, width);
+            std::vector<unsigned char> reference = randomPixels(width, width+1);
+            std::vector<double> error(width);
+            kernels->errorRow(&sampled[0], &reference[0], width, 2.0, &error[0]);
+            for(int x=0; x<width; x++) {
+                EXPECT_EQ((sampled[x] - (double)reference[x]) * 2.0, error[x]) << kernels->name;
+            }
+        }
+    }
+}
+
+TEST(Kernels, dot) {
+    for(const Stick::Kernels::Table* kernels : Stick::Kernels::getAvailable()) {
+        for(int width=1; width<100; width++) {
+            std::vector<double> a = randomValues(width, width);
+            std::vector<double> b = randomValues(width, width+1);
+            EXPECT_EQ(Stick::Kernels::Scalar.dot(&a[0], &b[0], width), kernels->dot(&a[0], &b[0], width)) << kernels->name;
+        }
+    }
+}
+
+TEST(Kernels, float_rows) {
+    for(const Stick::Kernels::Table* kernels : Stick::Kernels::getAvailable()) {
+        for(int width=1; width<40; width++) {
+            std::vector<unsigned char> image = randomPixels(width*3, width);
+            std::vector<float> dx(width, -1.0f), dy(width, -1.0f);
+            kernels->gradientRowFloat(&image[0], &image[width], &image[2*width], width, 0.5f, &dx[0], &dy[0]);
+            EXPECT_EQ(0.0f, dx[0]) << kernels->name;
+            EXPECT_EQ(0.0f, dy[width-1]) << kernels->name;
+            for(int x=1; x<width-1; x++) {
+                EXPECT_EQ((float)((int)image[width+x+1] - (int)image[width+x-1]) * 0.5f, dx[x]) << kernels->name;
+                EXPECT_EQ((float)((int)image[2*width+x] - (int)image[x]) * 0.5f, dy[x]) << kernels->name;
+            }
+
+            std::vector<double> values = randomValues(width*4, width);
+            std::vector<float> floats(values.begin(), values.end());
+            std::vector<float> out(width);
+            kernels->steepestRowFloat(&floats[0], &floats[width], &floats[2*width], &floats[3*width], width, &out[0]);
+            for(int x=0; x<width; x++) {
+                float expected = floats[x] * floats[2*width+x] + floats[width+x] * floats[3*width+x];
+                EXPECT_EQ(expected, out[x]) << kernels->name;
+            }
+
+            std::vector<float> error(width);
+            kernels->errorRowFloat(&floats[0], &image[0], width, 2.0f, &error[0]);
+            for(int x=0; x<width; x++) {
+                EXPECT_EQ((floats[x] - (float)image[x]) * 2.0f, error[x]) << kernels->name;
+            }
+        }
+        for(int width=1; width<100; width++) {
+            std::vector<double> a = randomValues(width, width);
+            std::vector<double> b = randomValues(width, width+1);
+            std::vector<float> fa(a.begin(), a.end()), fb(b.begin(), b.end());
+            double expected = Stick::Kernels::Scalar.dotFloat(&fa[0], &fb[0], width);
+            EXPECT_EQ(expected, kernels->dotFloat(&fa[0], &fb[0], width)) << kernels->name;
+            EXPECT_NEAR(Stick::Kernels::Scalar.dot(&a[0], &b[0], width), expected, 1e-4 * std::abs(expected) + 1e-2) << kernels->name;
+        }
+    }
+}
+
+TEST(Kernels, tile_dot) {
+    const int params = 8;
+    for(const Stick::Kernels::Table* kernels : Stick::Kernels::getAvailable()) {
+        for(int width=1; width<60; width++) {
+            int tiles = (width + Stick::Kernels::TileSize - 1) / Stick::Kernels::TileSize;
+            std::vector<double> values = randomValues(params*width, width);
+            std::vector<double> error = randomValues(width, width+1);
+            error.resize(tiles*Stick::Kernels::TileSize, 0.0);
+
+            // values[p*width + x] interleaved into tiles of 8 pixels
+            std::vector<double> tiled(tiles*params*Stick::Kernels::TileSize, 0.0);
+            std::vector<float> tiledFloat(tiled.size(), 0.0f), errorFloat(error.begin(), error.end());
+            for(int x=0; x<width; x++) {
+                for(int p=0; p<params; p++) {
+                    int index = ((x/8)*params + p)*8 + x%8;
+                    tiled[index] = values[p*width + x];
+                    tiledFloat[index] = (float)values[p*width + x];
+                }
+            }
+
+            std::vector<double> lanes(params*8, 0.0);
+            std::vector<float> lanesFloat(params*8, 0.0f);
+            kernels->tileDot(&tiled[0], &error[0], tiles, params, &lanes[0]);
+            kernels->tileDotFloat(&tiledFloat[0], &errorFloat[0], tiles, params, &lanesFloat[0]);
+            for(int p=0; p<params; p++) {
+                EXPECT_EQ(kernels->dot(&values[p*width], &error[0], width), Stick::Kernels::reduceLanes(&lanes[p*8])) << kernels->name;
+
+                std::vector<float> row(values.begin() + p*width, values.begin() + (p+1)*width);
+                EXPECT_EQ(kernels->dotFloat(&row[0], &errorFloat[0], width), Stick::Kernels::reduceLanes(&lanesFloat[p*8])) << kernels->name;
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <tracker/multi_tracker.hpp>
+#include <tracker/inverse_compositional.hpp>
+#include <tracker/esm.hpp>
+#include <model/homography.hpp>
+#include <model/affine.hpp>
+#include <model/translation.hpp>
+
+#include "allocation.hpp"
+
+static Stick::Tracker* createTracker(int i, const cv::Mat& templateImage) {
+    Stick::Model* model = NULL;
+    switch( i % 3 ) {
+        case 0: model = new Stick::Homography(); break;
+        case 1: model = new Stick::Affine(); break;
+        default: model = new Stick::Translation(); break;
+    }
+    Stick::InverseCompositional* tracker = NULL;
+    if( i % 2 ) {
+        tracker = new Stick::ESM(model, 0.05, 100, 2);
+    } else {
+        tracker = new Stick::InverseCompositional(model, 0.05, 100, 2);
+    }
+    tracker->setTemplateImage(templateImage);
+    return tracker;
+}
+
+TEST(MultiTracker, create) {
+    Stick::MultiTracker trackers(2);
+    EXPECT_EQ("MultiTracker", trackers.getName());
+    EXPECT_EQ(2, trackers.getThreads());
+    EXPECT_EQ(0, trackers.size());
+    EXPECT_THROW(trackers.add(NULL), Stick::InvalidParameters);
+    EXPECT_THROW(trackers.get(0), Stick::InvalidParameters);
+}
+
+TEST(MultiTracker, track) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+
+    // the same trackers one after the other on this thread
+    const int count = 7;
+    std::vector<cv::Matx33d> expected;
+    for(int i=0; i<count; i++) {
+        Stick::Tracker* tracker = createTracker(i, templateImage);
+        tracker->initialize();
+        tracker->track(image, 1.0);
+        expected.push_back(tracker->getModel()->getMatx());
+        delete tracker;
+    }
+
+    Stick::MultiTracker trackers(3);
+    for(int i=0; i<count; i++) {
+        EXPECT_EQ(i, trackers.add(createTracker(i, templateImage)));
+    }
+    trackers.initialize();
+    trackers.track(image);
+
+    const std::vector<cv::Matx33d>& poses = trackers.getPoses();
+    ASSERT_EQ(count, poses.size());
+    for(int i=0; i<count; i++) {
+        for(int k=0; k<9; k++) {
+            EXPECT_EQ(expected[i].val[k], poses[i].val[k]) << trackers.get(i)->getName() << " " << i;
+        }
+    }
+}
+
+TEST(MultiTracker, track_no_allocation) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat first = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat second = cv::imread("datas/im000_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+
+    Stick::MultiTracker trackers(3);
+    for(int i=0; i<6; i++) {
+        trackers.add(createTracker(i, templateImage));
+    }
+    trackers.initialize();
+    trackers.track(first);
+
+    // neither the batch handed to the pool nor the trackers allocate once the first frame sized their buffers
+    Allocation::start();
+    trackers.track(second, 0.5);
+    trackers.track(first);
+    int allocations = Allocation::stop();
+
+    EXPECT_EQ(0, allocations);
+}
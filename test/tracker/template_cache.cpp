@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include <tracker/template_cache.hpp>
+#include <tracker/inverse_compositional.hpp>
+#include <tracker/esm.hpp>
+#include <model/homography.hpp>
+
+static const char* CachePath = "template_cache_test.bin";
+
+static bool equals(const cv::Mat& a, const cv::Mat& b) {
+    if( a.rows != b.rows || a.cols != b.cols || a.type() != b.type() ) {
+        return false;
+    }
+    for(int r=0; r<a.rows; r++) {
+        if( memcmp(a.ptr(r), b.ptr(r), a.cols * a.elemSize()) != 0 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(TemplateCache, hash) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat changed = templateImage.clone();
+    changed.at<unsigned char>(changed.rows/2, changed.cols/2) ^= 1;
+
+    uint64_t key = Stick::TemplateCache::Hash(templateImage, "Homography");
+    EXPECT_EQ(key, Stick::TemplateCache::Hash(templateImage.clone(), "Homography"));
+    EXPECT_NE(key, Stick::TemplateCache::Hash(changed, "Homography"));
+    EXPECT_NE(key, Stick::TemplateCache::Hash(templateImage, "Affine"));
+}
+
+TEST(TemplateCache, save_load) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    Stick::ESM tracker(new Stick::Homography(), 0.05, 100, 2);
+    tracker.setTemplateImage( templateImage );
+    tracker.setPixelFraction( 0.5 );
+    tracker.initialize();
+    std::shared_ptr<const Stick::TemplateData> data = tracker.getTemplateData();
+
+    remove(CachePath);
+    EXPECT_FALSE((bool)Stick::TemplateCache::Load(CachePath, 1));
+    Stick::TemplateCache::Save(CachePath, *data, 1);
+    EXPECT_FALSE((bool)Stick::TemplateCache::Load(CachePath, 2));
+
+    std::shared_ptr<const Stick::TemplateData> loaded = Stick::TemplateCache::Load(CachePath, 1);
+    ASSERT_TRUE((bool)loaded);
+    EXPECT_EQ(data->modelName, loaded->modelName);
+    EXPECT_EQ(data->parameterSize, loaded->parameterSize);
+    EXPECT_EQ(data->depth, loaded->depth);
+    EXPECT_EQ(data->pixelFraction, loaded->pixelFraction);
+    ASSERT_EQ(data->levels.size(), loaded->levels.size());
+    for(int l=0; l<(int)data->levels.size(); l++) {
+        const Stick::TrackingLevel& expected = data->levels[l];
+        const Stick::TrackingLevel& actual = loaded->levels[l];
+        EXPECT_EQ(expected.scale, actual.scale);
+        EXPECT_TRUE(equals(expected.templateImage, actual.templateImage));
+        EXPECT_TRUE(equals(expected.gradients, actual.gradients));
+        EXPECT_TRUE(equals(expected.hessianInv, actual.hessianInv));
+        EXPECT_TRUE(equals(expected.steepest, actual.steepest));
+        EXPECT_TRUE(equals(expected.jacobians, actual.jacobians));
+        EXPECT_EQ(expected.pixels, actual.pixels);
+        EXPECT_EQ(expected.reference, actual.reference);
+        // matrices are read in place from the mapping, aligned like the ones cv::Mat allocates
+        EXPECT_EQ(0, (size_t)actual.steepest.data % 64);
+    }
+
+    // a truncated file is rejected, not read past its end
+    FILE* file = fopen(CachePath, "r+b");
+    ASSERT_TRUE(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    ASSERT_EQ(0, truncate(CachePath, size/2));
+    EXPECT_THROW(Stick::TemplateCache::Load(CachePath, 1), Stick::InvalidParameters);
+    remove(CachePath);
+}
+
+TEST(TemplateCache, load_malformed) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    Stick::ESM tracker(new Stick::Homography(), 0.05, 100, 2);
+    tracker.setTemplateImage( templateImage );
+    tracker.setPixelFraction( 0.5 );
+    tracker.initialize();
+    const Stick::TemplateData& data = *tracker.getTemplateData();
+    const Stick::TrackingLevel& level = data.levels[1];
+    remove(CachePath);
+
+    // every file is well formed, but a matrix or a pixel does not fit the template
+    std::vector<Stick::TemplateData> malformed(6, data);
+    malformed[0].levels[1].pixels.back() = level.templateImage.size().area();
+    malformed[1].levels[1].pixels[1] = level.pixels[0];
+    malformed[2].levels[1].reference.pop_back();
+    malformed[3].levels[1].hessianInv = level.hessianInv(cv::Rect(0, 0, 6, 6));
+    malformed[4].levels[1].steepest = level.steepest.rowRange(0, level.steepest.rows - 1);
+    malformed[5].levels[1].jacobians = level.jacobians.rowRange(0, 8);
+    for(int i=0; i<(int)malformed.size(); i++) {
+        Stick::TemplateCache::Save(CachePath, malformed[i], 1);
+        EXPECT_THROW(Stick::TemplateCache::Load(CachePath, 1), Stick::InvalidParameters) << i;
+    }
+
+    Stick::TemplateCache::Save(CachePath, data, 1);
+    EXPECT_TRUE((bool)Stick::TemplateCache::Load(CachePath, 1));
+    remove(CachePath);
+}
+
+TEST(TemplateCache, initialize) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    remove(CachePath);
+
+    Stick::InverseCompositional built(new Stick::Homography(), 0.05, 100, 2);
+    built.setTemplateImage( templateImage );
+    EXPECT_FALSE(built.initialize(CachePath));
+    built.track( image );
+
+    Stick::InverseCompositional loaded(new Stick::Homography(), 0.05, 100, 2);
+    loaded.setTemplateImage( templateImage );
+    EXPECT_TRUE(loaded.initialize(CachePath));
+    EXPECT_EQ(2, loaded.getPyramidLevel());
+    loaded.track( image );
+
+    cv::Mat expected = built.getModel()->get();
+    cv::Mat actual = loaded.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(expected.at<double>(i), actual.at<double>(i));
+    }
+
+    // another tracker, configuration or template misses and replaces the entry
+    Stick::ESM esm(new Stick::Homography(), 0.05, 100, 2);
+    esm.setTemplateImage( templateImage );
+    EXPECT_NE(loaded.getTemplateKey(), esm.getTemplateKey());
+    EXPECT_FALSE(esm.initialize(CachePath));
+    EXPECT_TRUE(esm.initialize(CachePath));
+
+    Stick::InverseCompositionalF single(new Stick::Homography(), 0.05, 100, 2);
+    single.setTemplateImage( templateImage );
+    EXPECT_FALSE(single.initialize(CachePath));
+    EXPECT_TRUE(single.initialize(CachePath));
+
+    Stick::InverseCompositional changed(new Stick::Homography(), 0.05, 100, 2);
+    cv::Mat changedImage = templateImage.clone();
+    changedImage.at<unsigned char>(0, 0) ^= 1;
+    changed.setTemplateImage( changedImage );
+    EXPECT_FALSE(changed.initialize(CachePath));
+    remove(CachePath);
+}
+
+TEST(TemplateCache, esm_from_loaded) {
+    cv::Mat templateImage = cv::imread("datas/im000.png", CV_LOAD_IMAGE_GRAYSCALE);
+    cv::Mat image = cv::imread("datas/im001_original.jpg", CV_LOAD_IMAGE_GRAYSCALE);
+    remove(CachePath);
+
+    Stick::InverseCompositional inverseCompositional(new Stick::Homography(), 0.05, 100, 2);
+    inverseCompositional.setTemplateImage( templateImage );
+    inverseCompositional.initialize();
+    Stick::TemplateCache::Save(CachePath, *inverseCompositional.getTemplateData(), 1);
+
+    Stick::ESM built(new Stick::Homography(), 0.05, 100, 2);
+    built.setTemplateData( inverseCompositional.getTemplateData() );
+    built.track( image );
+
+    // the ESM extends a copy of the loaded data with its jacobians, the copy keeps the file mapped
+    Stick::ESM loaded(new Stick::Homography(), 0.05, 100, 2);
+    std::shared_ptr<const Stick::TemplateData> data = Stick::TemplateCache::Load(CachePath, 1);
+    ASSERT_TRUE((bool)data);
+    loaded.setTemplateData( data );
+    EXPECT_EQ(data->owner, loaded.getTemplateData()->owner);
+    data.reset();
+    remove(CachePath);
+    loaded.track( image );
+
+    cv::Mat expected = built.getModel()->get();
+    cv::Mat actual = loaded.getModel()->get();
+    for(int i=0; i<9; i++) {
+        EXPECT_EQ(expected.at<double>(i), actual.at<double>(i));
+    }
+}